@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 
 #include "lib/Agent/Agent.hpp"
 #include "lib/DataManager/MemoryElement.hpp"
@@ -13,17 +14,43 @@ struct GameOptions
   uint simsPerMove;                            // the amount of MCTS simulations per move
   bool stochasticSearch              = true;   // if true, don't play the best move but use a stochastic distribution to select a move based on the visit counts
   std::filesystem::path memoryFolder = "data"; // the folder to save the games to. Each game will be saved in its own file
-  bool                  useDirichletNoise = true; // if true, add dirichlet noise to the root node on every move
-  DirichletNoiseOptions dirichletNoiseOptions;    // alpha and beta for the dirichlet noise which is added to the root node on every move
+  bool                  useDirichletNoise       = true;  // if true, add dirichlet noise to the root node on every move
+  DirichletNoiseOptions dirichletNoiseOptions;           // alpha and beta for the dirichlet noise which is added to the root node on every move
+  SearchOptions         searchOptions;                   // options for how the MCTS simulations of each move are run
+  bool                  reuseTree               = true;  // if true, keep the subtree of the played move as the root of the next search
+  uint                  evaluationCacheSize     = 0;     // amount of network evaluations to cache over all games, 0 disables the cache
+  bool                  playoutCapRandomization = false; // if true, most moves use a cheap search that isn't saved to memory
+  uint                  fastSimsPerMove         = 0;     // the amount of MCTS simulations of a cheap search
+  float                 fullSearchProbability   = 1.0F;  // the chance that a move uses a full search of simsPerMove simulations
+
+  GameOptions() = default; // the caller sets the options, used when they don't come from a config file
 
   GameOptions(std::filesystem::path const & file)
   {
-    auto config           = Configuration(file);
-    saveMemory            = config.Get<bool>("save_memory");
-    maxMoves              = config.Get<uint>("max_moves");
-    simsPerMove           = config.Get<uint>("sims_per_move");
-    stochasticSearch      = config.Get<bool>("stochastic_search");
-    dirichletNoiseOptions = DirichletNoiseOptions{
+    auto config             = Configuration(file);
+    saveMemory              = config.Get<bool>("save_memory");
+    maxMoves                = config.Get<uint>("max_moves");
+    simsPerMove             = config.Get<uint>("sims_per_move");
+    searchOptions           = SearchOptions{
+      .batchSize              = config.Get<uint>("sims_per_batch"),
+      .numThreads             = config.Get<uint>("search_threads"),
+      .asynchronous           = config.Get<bool>("async_search"),
+      .rootParallel           = config.Get<bool>("root_parallel"),
+      .transpositionTableSize = config.Get<uint>("transposition_table_size"),
+      .maxNodes               = config.Get<uint>("max_nodes"),
+      .useSolver              = config.Get<bool>("use_solver"),
+      .useGumbel              = config.Get<bool>("gumbel/enable"),
+      .gumbelConsideredMoves  = config.Get<uint>("gumbel/considered_moves"),
+      .stopEarly              = config.Get<bool>("early_stop/enable"),
+      .minSimulations         = config.Get<uint>("early_stop/min_sims"),
+    };
+    reuseTree               = config.Get<bool>("reuse_tree");
+    evaluationCacheSize     = config.Get<uint>("evaluation_cache_size");
+    playoutCapRandomization = config.Get<bool>("playout_cap_randomization/enable");
+    fastSimsPerMove         = config.Get<uint>("playout_cap_randomization/fast_sims_per_move");
+    fullSearchProbability   = config.Get<float>("playout_cap_randomization/full_search_probability");
+    stochasticSearch        = config.Get<bool>("stochastic_search");
+    dirichletNoiseOptions   = DirichletNoiseOptions{
       .enable            = config.Get<bool>("dirichlet_noise/enable"),
       .alpha             = config.Get<float>("dirichlet_noise/alpha"),
       .beta              = config.Get<float>("dirichlet_noise/beta"),
@@ -32,24 +59,35 @@ struct GameOptions
   }
 };
 
+template<GameEnvironment Env>
 class Game
 {
 private:
-  std::shared_ptr<Environment>        m_environment;
-  std::vector<std::shared_ptr<Agent>> m_agents;
-  GameOptions                         m_gameOptions;
-  uint                                m_gameID;
+  std::shared_ptr<Env>                    m_environment;
+  std::vector<std::shared_ptr<Agent>>     m_agents;
+  GameOptions                             m_gameOptions;
+  uint                                    m_gameID;
+  std::vector<std::shared_ptr<MCTS<Env>>> m_trees;                    // one search tree per network, kept between moves when the subtree is reused
+  std::vector<size_t>                     m_agentTrees;               // index into m_trees of the tree of each agent
+  uint                                    m_simulationsRun       = 0; // simulations run during this game
+  uint                                    m_simulationsRequested = 0; // simulations that would have run without stopping early
 
   std::vector<MemoryElement> m_memory;
 
 public:
-  Game(std::shared_ptr<Environment> environment, std::vector<std::shared_ptr<Agent>> const & agents, GameOptions gameOptions);
+  Game(std::shared_ptr<Env> environment, std::vector<std::shared_ptr<Agent>> const & agents, GameOptions gameOptions, uint gameID = 0);
   ~Game() = default;
 
   Player PlayGame();
   void   PlayMove();
 
+  MCTS<Env> const & GetTree(Player player) const; // search tree of the agent of the given player
+  uint              GetSimulationsRequested() const;
+
+  std::vector<MemoryElement> const & GetMemory() const; // moves of this game that are saved for training
+
 private:
-  void AddElementToMemory(std::shared_ptr<Environment> const & environment, Player currentPlayer, std::vector<std::shared_ptr<Node>> const & children);
+  bool CanReuseTree(MCTS<Env> const & mcts) const;
+  void AddElementToMemory(Env const & environment, Player currentPlayer, std::span<Node const> children, std::vector<float> const & policy);
   void SaveMemoryToFile(Player winner);
 };
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "Game.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "lib/DataManager/DataManager.hpp"
+#include "lib/Logging/Logger.hpp"
+#include "lib/Utilities/RandomGenerator.hpp"
+#include "lib/Utilities/Time.hpp"
+
+namespace
+{
+// with dirichlet noise, at least simsPerMove / MIN_FRESH_SIMULATIONS_DIVISOR simulations run on every move, however many visits were reused
+uint constexpr MIN_FRESH_SIMULATIONS_DIVISOR = 4;
+} // namespace
+
+template<GameEnvironment Env>
+Game<Env>::Game(std::shared_ptr<Env> environment, std::vector<std::shared_ptr<Agent>> const & agents, GameOptions gameOptions, uint gameID)
+  : m_environment(std::move(environment))
+  , m_agents(agents)
+  , m_gameOptions(std::move(gameOptions))
+  , m_gameID(gameID)
+{
+  // every game has its own random stream, so a game can be replayed from the seed of the run and its ID
+  RandomGenerator::SetStream(m_gameID, 0);
+
+  // a reused subtree holds the evaluations of the network that searched it, so agents only share a tree if they share a network
+  for (size_t i = 0; i < m_agents.size(); i++)
+  {
+    size_t tree = m_trees.size();
+    for (size_t j = 0; j < i; j++)
+    {
+      if (m_agents[j]->GetNeuralNetwork() == m_agents[i]->GetNeuralNetwork())
+      {
+        tree = m_agentTrees[j];
+        break;
+      }
+    }
+    if (tree == m_trees.size())
+    {
+      m_trees.push_back(std::make_shared<MCTS<Env>>(*m_environment, m_gameOptions.dirichletNoiseOptions, m_gameOptions.searchOptions));
+    }
+    m_agentTrees.push_back(tree);
+  }
+}
+
+template<GameEnvironment Env>
+Player Game<Env>::PlayGame()
+{
+  LINFO << "Starting new game";
+  uint moveCounter = 0;
+  while (!m_environment->IsTerminal())
+  {
+    LINFO << "Move " << moveCounter + 1;
+    m_environment->PrintBoard();
+    if (moveCounter > m_gameOptions.maxMoves)
+    {
+      LINFO << "Game exceeded max moves";
+      break;
+    }
+
+    PlayMove();
+    moveCounter++;
+  }
+
+  m_environment->PrintBoard();
+
+  // game is terminal, get winner
+  auto winner = m_environment->GetWinner();
+  LINFO << "Winner: " << m_environment->PlayerToString(winner);
+  LINFO << "Ran " << m_simulationsRun << " of " << m_simulationsRequested << " simulations this game";
+  LINFO << "Saved " << m_memory.size() << " of " << moveCounter << " moves to memory";
+  SaveMemoryToFile(winner);
+  return winner;
+}
+
+template<GameEnvironment Env>
+void Game<Env>::PlayMove()
+{
+  LINFO << "=================== Playing move ===================";
+  // run simulations
+  auto currentPlayer = m_environment->GetCurrentPlayer();
+
+  Agent * currentAgent;
+  try
+  {
+    currentAgent = m_agents[(int)currentPlayer - 1].get();
+  }
+  catch (std::exception const & e)
+  {
+    LWARN << "Could not get agent for player " << m_environment->PlayerToString(currentPlayer);
+    LWARN << "Exception: " << e.what();
+    throw std::runtime_error("Could not get agent for player " + m_environment->PlayerToString(currentPlayer));
+  }
+
+  auto mcts = m_trees[m_agentTrees[(int)currentPlayer - 1]];
+  if (!CanReuseTree(*mcts))
+  {
+    mcts->ResetRoot(*m_environment);
+  }
+
+  // visits kept from the previous search count towards the simulations of this move
+  uint reusedVisits = mcts->GetRoot().GetVisitCount();
+  if (reusedVisits > 0)
+  {
+    LINFO << "Reusing subtree with " << reusedVisits << " visits";
+  }
+  // playout cap randomization: only a random part of the moves gets a full search, the others use a cheap search without noise
+  bool fullSearch     = !m_gameOptions.playoutCapRandomization || RandomGenerator::GenerateUniform() < m_gameOptions.fullSearchProbability;
+  uint simsPerMove    = fullSearch ? m_gameOptions.simsPerMove : m_gameOptions.fastSimsPerMove;
+  uint numSimulations = simsPerMove > reusedVisits ? simsPerMove - reusedVisits : 0;
+  bool addNoise       = fullSearch && m_gameOptions.dirichletNoiseOptions.enable;
+  if (addNoise)
+  {
+    // the noise added to the root only has an effect through new simulations, so a large reused subtree doesn't replace them all
+    numSimulations = std::max(numSimulations, simsPerMove / MIN_FRESH_SIMULATIONS_DIVISOR);
+  }
+  mcts->EnableDirichletNoise(addNoise);
+  auto statistics = currentAgent->RunSimulations(mcts, numSimulations);
+  m_simulationsRun += statistics.simulations;
+  m_simulationsRequested += numSimulations;
+  Node const & root = mcts->GetRoot();
+  if (fullSearch)
+  {
+    // the visit counts of a cheap search are a poor policy target, so only full searches are used for training
+    AddElementToMemory(mcts->GetRootEnvironment(), currentPlayer, mcts->GetChildren(root), mcts->GetPolicyTarget());
+  }
+
+  // print possible moves
+  LDEBUG << "Possible moves:";
+  for (auto const & child: mcts->GetChildren(root))
+  {
+    LDEBUG << "[" << child.GetMove().ToString() << "] P = " << child.GetPriorProbability() << ", Q = " << child.GetQValue()
+           << ", U = " << child.GetUValue(root) << ", N = " << child.GetVisitCount();
+  }
+
+  // based on the simulations, get the best move
+  Move bestMove = mcts->GetBestMove(m_gameOptions.stochasticSearch);
+  LINFO << "Best move: " << bestMove.ToString();
+  m_environment->MakeMove(bestMove);
+
+  // every tree follows the game, the subtree of the played move becomes the root of the next search of its agents
+  for (auto const & tree: m_trees)
+  {
+    if (!m_gameOptions.reuseTree || !tree->AdvanceRoot(bestMove))
+    {
+      tree->ResetRoot(*m_environment);
+    }
+  }
+}
+
+template<GameEnvironment Env>
+MCTS<Env> const & Game<Env>::GetTree(Player player) const
+{
+  return *m_trees[m_agentTrees[(int)player - 1]];
+}
+
+template<GameEnvironment Env>
+uint Game<Env>::GetSimulationsRequested() const
+{
+  return m_simulationsRequested;
+}
+
+template<GameEnvironment Env>
+std::vector<MemoryElement> const & Game<Env>::GetMemory() const
+{
+  return m_memory;
+}
+
+template<GameEnvironment Env>
+bool Game<Env>::CanReuseTree(MCTS<Env> const & mcts) const
+{
+  // the environment could have been changed outside of the game, only reuse the tree if its root is still the same position
+  auto const & rootEnvironment = mcts.GetRootEnvironment();
+  // the hash includes the player to move
+  return rootEnvironment.GetHash() == m_environment->GetHash();
+}
+
+template<GameEnvironment Env>
+void Game<Env>::AddElementToMemory(Env const & environment, Player currentPlayer, std::span<Node const> children, std::vector<float> const & policy)
+{
+  // add moves to list of moves, with the policy target of the search as their probability
+  std::vector<std::pair<Move, float>> moves;
+  moves.reserve(children.size());
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    moves.emplace_back(children[i].GetMove(), policy[i]);
+  }
+
+  // create memory element
+  MemoryElement memoryElement(environment.GetBoard().clone(), currentPlayer, Player::PLAYER_NONE, moves);
+  m_memory.push_back(memoryElement);
+}
+
+template<GameEnvironment Env>
+void Game<Env>::SaveMemoryToFile(Player winner)
+{
+  // set winner in all memory elements
+  for (auto & element: m_memory)
+  {
+    element.winner = winner;
+  }
+  // save to file
+  try
+  {
+    DataManager::SaveGame(m_gameOptions.memoryFolder / ("game_" + GetTimeAsString("%Y%m%d-%H%M%S") + ".bin"), m_memory);
+  }
+  catch (std::exception const & e)
+  {
+    LWARN << "Failed to save game to file. Exception: " << e.what();
+    throw std::runtime_error("Failed to save game to file");
+  }
+}
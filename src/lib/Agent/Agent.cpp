@@ -8,7 +8,7 @@ Agent::Agent(std::string name, std::shared_ptr<NeuralNetworkInterface> neuralNet
 {
 }
 
-void Agent::RunSimulations(std::shared_ptr<MCTS> const & mcts, uint numSimulations)
+std::shared_ptr<NeuralNetworkInterface> const & Agent::GetNeuralNetwork() const
 {
-  mcts->RunSimulations(numSimulations, *m_neuralNetwork);
+  return m_neuralNetwork;
 }
@@ -24,5 +24,10 @@ public:
   Agent(std::string name, std::shared_ptr<NeuralNetworkInterface> neuralNetwork);
   ~Agent() = default;
 
-  void RunSimulations(std::shared_ptr<MCTS> const & mcts, uint numSimulations);
-};
\ No newline at end of file
+  std::shared_ptr<NeuralNetworkInterface> const & GetNeuralNetwork() const;
+
+  template<GameEnvironment Env>
+  SearchStatistics RunSimulations(std::shared_ptr<MCTS<Env>> const & mcts, uint numSimulations);
+};
+
+#include "Agent.ipp"
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "Agent.hpp"
+
+template<GameEnvironment Env>
+SearchStatistics Agent::RunSimulations(std::shared_ptr<MCTS<Env>> const & mcts, uint numSimulations)
+{
+  return mcts->RunSimulations(numSimulations, *m_neuralNetwork);
+}
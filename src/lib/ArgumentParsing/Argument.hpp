@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -28,6 +30,7 @@ struct Arguments
   std::filesystem::path trainConfigPath         = "config/train/default.jsonc";
 
   // misc
-  std::filesystem::path dataFolder = "data";
-  bool                  useCuda    = false; // for selfplay, I noticed worse performance when using CUDA
+  std::filesystem::path   dataFolder = "data";
+  bool                    useCuda    = false; // for selfplay, I noticed worse performance when using CUDA
+  std::optional<uint64_t> seed;               // seed of the random numbers, random if not given
 };
\ No newline at end of file
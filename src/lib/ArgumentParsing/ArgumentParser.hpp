@@ -26,6 +26,7 @@ auto constexpr PARAMETER_GAME_CONFIG          = "--game-config";
 auto constexpr PARAMETER_TRAIN_CONFIG         = "--train-config";
 auto constexpr PARAMETER_DATA_FOLDER          = "--data-folder";
 auto constexpr PARAMETER_CUDA                 = "--cuda";
+auto constexpr PARAMETER_SEED                 = "--seed";
 
 auto constexpr PARAMETER_MODEL1 = "--model1";
 auto constexpr PARAMETER_MODEL2 = "--model2";
@@ -50,7 +51,8 @@ void PrintHelpMessage(std::string const & programName)
             << "  " << PARAMETER_TRAIN_CONFIG << " <path>           Path to the training configuration to load\n"
             << "Misc\n"
             << "  " << PARAMETER_DATA_FOLDER << " <path>            Path to the folder where games are loaded/stored\n"
-            << "  " << PARAMETER_CUDA << "                          Use CUDA (GPU) if available (default: false)";
+            << "  " << PARAMETER_CUDA << "                          Use CUDA (GPU) if available (default: false)\n"
+            << "  " << PARAMETER_SEED << " <number>                 Seed of the random numbers, to repeat a run (default: random)";
   std::cout << std::endl;
 }
 
@@ -201,6 +203,14 @@ void GetDeviceOptions(InputParser const & input, Arguments & arguments)
   }
 }
 
+void GetSeed(InputParser const & input, Arguments & arguments)
+{
+  if (input.CmdOptionExists(PARAMETER_SEED))
+  {
+    arguments.seed = std::stoull(input.GetCmdOption(PARAMETER_SEED));
+  }
+}
+
 void GetEvaluationModels(InputParser const & input, Arguments & arguments)
 {
   if (input.CmdOptionExists(PARAMETER_MODEL1) && input.CmdOptionExists(PARAMETER_MODEL2))
@@ -244,6 +254,7 @@ Arguments ParseArguments(int argc, char ** argv)
   {
     arguments.mode = GetMode(input);
     GetDeviceOptions(input, arguments);
+    GetSeed(input, arguments);
 
     // training
     switch (arguments.mode)
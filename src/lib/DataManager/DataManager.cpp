@@ -60,7 +60,7 @@ void DataManager::SaveGame(std::filesystem::path const & file, std::vector<Memor
     for (auto const & move: element.moves)
     {
       // Write the move
-      WriteMove(outFile, *move.first, move.second);
+      WriteMove(outFile, move.first, move.second);
     }
   }
   outFile.close();
@@ -14,8 +14,6 @@ public:
 
   static void SaveGame(std::filesystem::path const & file, std::vector<MemoryElement> const & memoryElements);
 
-  template<typename MoveType>
-    requires std::is_base_of_v<Move, MoveType>
   static std::vector<MemoryElement> LoadGame(std::filesystem::path const & file)
   {
 
@@ -94,12 +92,12 @@ public:
       }
 
       // Create the memory element
-      std::vector<std::pair<std::shared_ptr<Move>, float>> moves;
+      std::vector<std::pair<Move, float>> moves;
+      moves.reserve(numMoves);
       for (int j = 0; j < numMoves; j++)
       {
         // Read the move and add it to the move history
-        auto movePair = ReadMove<MoveType>(inFile);
-        moves.emplace_back(std::make_shared<MoveType>(movePair.first), movePair.second);
+        moves.emplace_back(ReadMove(inFile));
       }
       memoryElements.emplace_back(board, static_cast<Player>(currentPlayer), static_cast<Player>(winner), moves);
     }
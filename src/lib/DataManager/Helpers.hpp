@@ -72,9 +72,7 @@ inline void WritePlayer(std::ofstream & outFile, Player player)
   }
 }
 
-template<typename MoveType>
-  requires std::is_base_of_v<Move, MoveType>
-std::pair<MoveType, float> ReadMove(std::ifstream & inFile)
+inline std::pair<Move, float> ReadMove(std::ifstream & inFile)
 {
   uint moveRow;
   inFile.read(reinterpret_cast<char *>(&moveRow), sizeof(moveRow));
@@ -98,21 +96,19 @@ std::pair<MoveType, float> ReadMove(std::ifstream & inFile)
   {
     throw std::runtime_error("Invalid move probability, must be in range [0, 1]");
   }
-  return {MoveType{moveRow, moveCol, probability}, probability};
+  return {Move(moveRow, moveCol), probability};
 }
 
-template<typename MoveType>
-  requires std::is_same_v<MoveType, Move>
-void WriteMove(std::ofstream & outFile, MoveType const & move, float probability)
+inline void WriteMove(std::ofstream & outFile, Move move, float probability)
 {
-  // write with padding
-  auto row = move.GetRow();
+  // write with padding, the coordinates are stored as uint
+  uint row = move.GetRow();
   outFile.write(reinterpret_cast<char const *>(&row), sizeof(row));
   if (outFile.fail())
   {
     throw std::runtime_error("Failed to write move row");
   }
-  auto col = move.GetColumn();
+  uint col = move.GetColumn();
   outFile.write(reinterpret_cast<char const *>(&col), sizeof(col));
   if (outFile.fail())
   {
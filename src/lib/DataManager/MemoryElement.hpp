@@ -10,7 +10,7 @@
 
 struct MemoryElement
 {
-  MemoryElement(torch::Tensor board_, Player currentPlayer_, Player winner_, std::vector<std::pair<std::shared_ptr<Move>, float>> moves_)
+  MemoryElement(torch::Tensor board_, Player currentPlayer_, Player winner_, std::vector<std::pair<Move, float>> moves_)
     : board(std::move(board_))
     , currentPlayer(currentPlayer_)
     , winner(winner_)
@@ -48,7 +48,7 @@ struct MemoryElement
     {
       for (auto const & [move, prob]: moves)
       {
-        output[move->GetIndex()] = prob;
+        output[(int64_t)move.GetIndex(board.size(1))] = prob;
       }
       output[output.size(0) - 1] = static_cast<float>(winner);
       output                     = output.unsqueeze(0);
@@ -61,8 +61,8 @@ struct MemoryElement
     return {input, output};
   }
 
-  torch::Tensor                                        board;         // board at this state
-  Player                                               currentPlayer; // player whose turn it is
-  Player                                               winner;        // winner of the game
-  std::vector<std::pair<std::shared_ptr<Move>, float>> moves;         // possible moves at this state with their visit counts
+  torch::Tensor                       board;         // board at this state
+  Player                              currentPlayer; // player whose turn it is
+  Player                              winner;        // winner of the game
+  std::vector<std::pair<Move, float>> moves;         // possible moves at this state with their visit counts
 };
\ No newline at end of file
@@ -29,23 +29,31 @@ public:
   virtual void   SetCurrentPlayer(Player player) = 0;
   virtual void   TogglePlayer()                  = 0;
 
-  virtual void MakeMove(Move const & move)              = 0;
+  virtual void MakeMove(Move move)                      = 0;
   virtual void UndoMove()                               = 0;
   virtual bool IsValidMove(uint row, uint column) const = 0;
 
-  [[nodiscard]] virtual std::vector<std::shared_ptr<Move>>         GetValidMoves() const  = 0;
-  [[nodiscard]] virtual std::vector<std::shared_ptr<Move>> const & GetMoveHistory() const = 0;
+  [[nodiscard]] virtual MoveList                  GetValidMoves() const  = 0;
+  [[nodiscard]] virtual std::vector<Move> const & GetMoveHistory() const = 0;
 
   virtual int GetRows() const    = 0;
   virtual int GetColumns() const = 0;
 
   virtual Player GetPlayerAtCoordinates(uint row, uint column) const = 0;
 
-  virtual torch::Tensor const & GetBoard() const                                            = 0;
-  virtual void                  SetBoard(torch::Tensor const & board, Player currentPlayer) = 0;
+  [[nodiscard]] virtual torch::Tensor GetBoard() const                                            = 0;
+  virtual void                        SetBoard(torch::Tensor const & board, Player currentPlayer) = 0;
 
   [[nodiscard]] virtual torch::Tensor BoardToInput() const = 0;
 
+  // writes the input of this position into entry index of a preallocated batch of shape {batch, planes, rows, columns},
+  // which has to be a contiguous float tensor on the cpu. Doesn't allocate, so a batch can be filled position by position
+  virtual void BoardToInput(torch::Tensor & batch, int64_t index) const = 0;
+  virtual int  GetInputPlanes() const                                   = 0;
+
+  // zobrist hash of the board and the player to move, updated by every move instead of being computed from the board
+  virtual uint64_t GetHash() const = 0;
+
   virtual bool   IsTerminal() const = 0;
   virtual Player GetWinner() const  = 0;
 
@@ -4,29 +4,74 @@
 
 #include "../Logging/Logger.hpp"
 #include "../NeuralNetwork/Device.hpp"
+#include "../Utilities/Zobrist.hpp"
 
 namespace
 {
 auto constexpr BOARD_SIZE_ROWS = 3;
 auto constexpr BOARD_SIZE_COLS = 3;
 auto constexpr INPUT_PLANES    = 3; // 3 planes of rows * columns: player 1, player 2, current player
-} // namespace
+auto constexpr FULL_BOARD      = uint16_t{(1U << (BOARD_SIZE_ROWS * BOARD_SIZE_COLS)) - 1};
 
-EnvironmentTicTacToe::EnvironmentTicTacToe()
-  : m_board(torch::zeros({BOARD_SIZE_ROWS, BOARD_SIZE_COLS}, Device::GetInstance().GetDevice()))
+// masks of the 8 lines of three cells: 3 rows, 3 columns and 2 diagonals
+std::array<uint16_t, 8> constexpr LINES = {0b000000111, 0b000111000, 0b111000000, 0b001001001, 0b010010010, 0b100100100, 0b100010001, 0b001010100};
+
+// for every possible mask of the cells of a player, whether it contains a full line
+auto constexpr WINNING_MASKS = []()
+{
+  std::array<bool, FULL_BOARD + 1> winning{};
+  for (uint mask = 0; mask <= FULL_BOARD; mask++)
+  {
+    for (auto line: LINES)
+    {
+      winning[mask] = winning[mask] || (mask & line) == line;
+    }
+  }
+  return winning;
+}();
+
+uint16_t GetCellMask(uint row, uint column)
+{
+  return uint16_t(1U << (row * BOARD_SIZE_COLS + column));
+}
+
+size_t GetPlayerIndex(Player player)
+{
+  return player == Player::PLAYER_1 ? 0 : 1;
+}
+
+// zobrist keys of every player on every cell, and of every player to move, the same keys HashBoard uses
+auto constexpr CELL_KEYS = []()
+{
+  std::array<std::array<uint64_t, 3>, BOARD_SIZE_ROWS * BOARD_SIZE_COLS> keys{};
+  for (size_t cell = 0; cell < keys.size(); cell++)
+  {
+    for (size_t player = 0; player < keys[cell].size(); player++)
+    {
+      keys[cell][player] = GetZobristKey((int64_t)cell, (int64_t)player);
+    }
+  }
+  return keys;
+}();
+auto constexpr PLAYER_KEYS = std::array<uint64_t, 3>{GetZobristKey(-1, 0), GetZobristKey(-1, 1), GetZobristKey(-1, 2)};
+
+uint64_t GetCellKey(uint row, uint column, Player player)
 {
+  return CELL_KEYS[row * BOARD_SIZE_COLS + column][static_cast<size_t>(player)];
 }
+} // namespace
 
-EnvironmentTicTacToe::EnvironmentTicTacToe(EnvironmentTicTacToe const & other)
-  : m_board(other.GetBoard().clone()) // clone the board because otherwise it will be a reference to the original board
-  , m_moveHistory(other.GetMoveHistory())
-  , m_currentPlayer(other.GetCurrentPlayer())
+EnvironmentTicTacToe::EnvironmentTicTacToe()
+  : m_hash(ComputeHash())
 {
+  m_moveHistory.reserve(BOARD_SIZE_ROWS * BOARD_SIZE_COLS);
 }
 
+EnvironmentTicTacToe::EnvironmentTicTacToe(EnvironmentTicTacToe const & other) = default;
+
 std::unique_ptr<Environment> EnvironmentTicTacToe::Clone() const
 {
-  return std::make_unique<EnvironmentTicTacToe>(EnvironmentTicTacToe(*this));
+  return std::make_unique<EnvironmentTicTacToe>(*this);
 }
 
 Player EnvironmentTicTacToe::GetCurrentPlayer() const
@@ -36,6 +81,7 @@ Player EnvironmentTicTacToe::GetCurrentPlayer() const
 
 void EnvironmentTicTacToe::SetCurrentPlayer(Player player)
 {
+  m_hash ^= PLAYER_KEYS[static_cast<size_t>(m_currentPlayer)] ^ PLAYER_KEYS[static_cast<size_t>(player)];
   m_currentPlayer = player;
 }
 
@@ -43,17 +89,18 @@ void EnvironmentTicTacToe::TogglePlayer()
 {
   if (m_currentPlayer == Player::PLAYER_NONE)
     return;
-  m_currentPlayer = (m_currentPlayer == Player::PLAYER_1) ? Player::PLAYER_2 : Player::PLAYER_1;
+  SetCurrentPlayer((m_currentPlayer == Player::PLAYER_1) ? Player::PLAYER_2 : Player::PLAYER_1);
 }
 
-void EnvironmentTicTacToe::MakeMove(Move const & move)
+void EnvironmentTicTacToe::MakeMove(Move move)
 {
   if (!IsValidMove(move.GetRow(), move.GetColumn()))
   {
     throw std::runtime_error("Invalid move: " + move.ToString());
   }
-  m_board[move.GetRow()][move.GetColumn()] = static_cast<int>(m_currentPlayer);
-  m_moveHistory.emplace_back(std::move(std::make_shared<MoveTicTacToe>(move.GetRow(), move.GetColumn(), 0.0F)));
+  m_pieces[GetPlayerIndex(m_currentPlayer)] |= GetCellMask(move.GetRow(), move.GetColumn());
+  m_hash ^= GetCellKey(move.GetRow(), move.GetColumn(), m_currentPlayer);
+  m_moveHistory.push_back(move);
   TogglePlayer();
 }
 
@@ -63,64 +110,102 @@ void EnvironmentTicTacToe::UndoMove()
   {
     throw std::runtime_error("Cannot undo move, move history is empty.");
   }
-  auto * move                                = m_moveHistory.back().get();
-  m_board[move->GetRow()][move->GetColumn()] = static_cast<int>(Player::PLAYER_NONE);
+  Move     move = m_moveHistory.back();
+  uint16_t cell = GetCellMask(move.GetRow(), move.GetColumn());
+  m_hash ^= GetCellKey(move.GetRow(), move.GetColumn(), GetPlayerAtCoordinates(move.GetRow(), move.GetColumn()));
+  m_pieces[0] &= uint16_t(~cell);
+  m_pieces[1] &= uint16_t(~cell);
   m_moveHistory.pop_back();
   TogglePlayer();
 }
 
 bool EnvironmentTicTacToe::IsValidMove(uint row, uint column) const
 {
-  return static_cast<Player>(m_board[row][column].item<int>()) == Player::PLAYER_NONE;
+  // a cell outside the board has no bit in the mask, so it has to be rejected before the mask is built
+  return row < BOARD_SIZE_ROWS && column < BOARD_SIZE_COLS && (GetOccupiedCells() & GetCellMask(row, column)) == 0;
 }
 
-std::vector<std::shared_ptr<Move>> EnvironmentTicTacToe::GetValidMoves() const
+MoveList EnvironmentTicTacToe::GetValidMoves() const
 {
-  std::vector<std::shared_ptr<Move>> validMoves;
-  for (uint row = 0; row < m_board.size(0); ++row)
+  MoveList validMoves;
+  uint16_t occupied = GetOccupiedCells();
+  for (uint row = 0; row < BOARD_SIZE_ROWS; ++row)
   {
-    for (uint column = 0; column < m_board.size(1); ++column)
+    for (uint column = 0; column < BOARD_SIZE_COLS; ++column)
     {
-      if (IsValidMove(row, column))
+      if ((occupied & GetCellMask(row, column)) == 0)
       {
-        // TODO: which prior probability should be used at construction?
-        validMoves.emplace_back(std::make_shared<MoveTicTacToe>(row, column, 0.0F));
+        validMoves.push_back(Move(row, column));
       }
     }
   }
   return validMoves;
 }
 
-std::vector<std::shared_ptr<Move>> const & EnvironmentTicTacToe::GetMoveHistory() const
+std::vector<Move> const & EnvironmentTicTacToe::GetMoveHistory() const
 {
   return m_moveHistory;
 }
 
 int EnvironmentTicTacToe::GetRows() const
 {
-  return m_board.size(0);
+  return BOARD_SIZE_ROWS;
 }
 
 int EnvironmentTicTacToe::GetColumns() const
 {
-  return m_board.size(1);
+  return BOARD_SIZE_COLS;
 }
 
 Player EnvironmentTicTacToe::GetPlayerAtCoordinates(uint row, uint column) const
 {
-  return static_cast<Player>(m_board[row][column].item<int>());
+  uint16_t cell = GetCellMask(row, column);
+  if (m_pieces[0] & cell)
+  {
+    return Player::PLAYER_1;
+  }
+  if (m_pieces[1] & cell)
+  {
+    return Player::PLAYER_2;
+  }
+  return Player::PLAYER_NONE;
 }
 
-torch::Tensor const & EnvironmentTicTacToe::GetBoard() const
+torch::Tensor EnvironmentTicTacToe::GetBoard() const
 {
-  return m_board;
+  // every cell holds the number of the player that occupies it
+  torch::Tensor board = torch::zeros({BOARD_SIZE_ROWS, BOARD_SIZE_COLS});
+  auto          cells = board.accessor<float, 2>();
+  for (uint row = 0; row < BOARD_SIZE_ROWS; ++row)
+  {
+    for (uint column = 0; column < BOARD_SIZE_COLS; ++column)
+    {
+      cells[row][column] = static_cast<float>(GetPlayerAtCoordinates(row, column));
+    }
+  }
+  return board.to(Device::GetInstance().GetDevice());
 }
 
 void EnvironmentTicTacToe::SetBoard(torch::Tensor const & board, Player currentPlayer)
 {
-  m_board = board;
+  // read the cells once, instead of indexing the tensor for every cell
+  auto cpuBoard = board.to(torch::kCPU, torch::kInt32).contiguous();
+  auto cells    = cpuBoard.accessor<int32_t, 2>();
+  m_pieces      = {0, 0};
+  for (uint row = 0; row < BOARD_SIZE_ROWS; ++row)
+  {
+    for (uint column = 0; column < BOARD_SIZE_COLS; ++column)
+    {
+      auto player = static_cast<Player>(cells[row][column]);
+      if (player != Player::PLAYER_NONE)
+      {
+        m_pieces[GetPlayerIndex(player)] |= GetCellMask(row, column);
+      }
+    }
+  }
   m_moveHistory.clear();
-  SetCurrentPlayer(currentPlayer);
+  m_currentPlayer = currentPlayer;
+  m_hash          = ComputeHash();
 }
 
 bool EnvironmentTicTacToe::IsTerminal() const
@@ -140,53 +225,29 @@ Player EnvironmentTicTacToe::GetWinner() const
 {
   // the winner is the player with three in a row
   // if there is no winner (yet), return PLAYER_NONE
-
-  // check horizontal win
-  for (uint row = 0; row < m_board.size(0); ++row)
+  if (WINNING_MASKS[m_pieces[0]])
   {
-    auto cellsInRow = m_board[row];
-    if (cellsInRow[0].equal(cellsInRow[1]) && cellsInRow[1].equal(cellsInRow[2]))
-    {
-      return static_cast<Player>(cellsInRow[0].item<int>());
-    }
+    return Player::PLAYER_1;
   }
-  // check vertical win
-  for (uint column = 0; column < m_board.size(1); ++column)
+  if (WINNING_MASKS[m_pieces[1]])
   {
-    auto cellsInColumn = m_board.transpose(0, 1)[column];
-    if (cellsInColumn[0].equal(cellsInColumn[1]) && cellsInColumn[1].equal(cellsInColumn[2]))
-    {
-      return static_cast<Player>(cellsInColumn[0].item<int>());
-    }
-  }
-  // check diagonal win
-  auto cellToCheck = m_board[1][1]; // middle cell
-  if (static_cast<Player>(cellToCheck.item<int>()) != Player::PLAYER_NONE)
-  {
-    if (m_board[0][0].equal(cellToCheck) && cellToCheck.equal(m_board[2][2]))
-    {
-      return static_cast<Player>(cellToCheck.item<int>());
-    }
-    if (m_board[0][2].equal(cellToCheck) && cellToCheck.equal(m_board[2][0]))
-    {
-      return static_cast<Player>(cellToCheck.item<int>());
-    }
+    return Player::PLAYER_2;
   }
   return Player::PLAYER_NONE;
 }
 
+uint64_t EnvironmentTicTacToe::GetHash() const
+{
+  return m_hash;
+}
+
 torch::Tensor EnvironmentTicTacToe::BoardToInput() const
 {
   try
   {
-    torch::Tensor input = torch::zeros({INPUT_PLANES, m_board.size(0), m_board.size(1)}, Device::GetInstance().GetDevice());
-    // first plane is where player 1 has pieces
-    // second plane is where player 2 has pieces
-    // third plane shows which player's turn it is
-    input[0] = m_board.where(m_board == static_cast<int>(Player::PLAYER_1), 0);
-    input[1] = m_board.where(m_board == static_cast<int>(Player::PLAYER_2), 0);
-    input[2] = torch::full({m_board.size(0), m_board.size(1)}, static_cast<int>(m_currentPlayer));
-    return input.unsqueeze(0);
+    torch::Tensor input = torch::empty({1, INPUT_PLANES, BOARD_SIZE_ROWS, BOARD_SIZE_COLS});
+    BoardToInput(input, 0);
+    return input.to(Device::GetInstance().GetDevice());
   }
   catch (std::exception const & e)
   {
@@ -195,25 +256,53 @@ torch::Tensor EnvironmentTicTacToe::BoardToInput() const
   }
 }
 
+void EnvironmentTicTacToe::BoardToInput(torch::Tensor & batch, int64_t index) const
+{
+  if (!batch.device().is_cpu() || batch.scalar_type() != torch::kFloat32 || !batch.is_contiguous() || batch.dim() != 4 || batch.size(1) != INPUT_PLANES
+      || batch.size(2) != BOARD_SIZE_ROWS || batch.size(3) != BOARD_SIZE_COLS || index < 0 || index >= batch.size(0))
+  {
+    throw std::runtime_error("BoardToInput needs a contiguous float batch on the cpu with room for the input at index " + std::to_string(index));
+  }
+  // first plane is where player 1 has pieces
+  // second plane is where player 2 has pieces
+  // third plane shows which player's turn it is
+  // the pieces keep the number of their player, the same values the network was trained on.
+  // the planes are stored row by row, so the cells are in the same order as the bits of the bitboards
+  auto constexpr CELLS  = BOARD_SIZE_ROWS * BOARD_SIZE_COLS;
+  float *        planes = batch.data_ptr<float>() + index * INPUT_PLANES * CELLS;
+  for (uint cell = 0; cell < CELLS; ++cell)
+  {
+    uint16_t mask              = uint16_t(1U << cell);
+    planes[cell]               = (m_pieces[0] & mask) ? static_cast<float>(Player::PLAYER_1) : 0.0F;
+    planes[CELLS + cell]       = (m_pieces[1] & mask) ? static_cast<float>(Player::PLAYER_2) : 0.0F;
+    planes[(2 * CELLS) + cell] = static_cast<float>(m_currentPlayer);
+  }
+}
+
+int EnvironmentTicTacToe::GetInputPlanes() const
+{
+  return INPUT_PLANES;
+}
+
 void EnvironmentTicTacToe::PrintBoard() const
 {
   std::ostringstream oss;
   oss << std::endl;
-  auto printDashes = [this, &oss]()
+  auto printDashes = [&oss]()
   {
-    for (uint column = 0; column < m_board.size(1); ++column)
+    for (uint column = 0; column < BOARD_SIZE_COLS; ++column)
     {
       oss << "----";
     }
     oss << "-" << std::endl;
   };
 
-  for (uint row = 0; row < m_board.size(0); ++row)
+  for (uint row = 0; row < BOARD_SIZE_ROWS; ++row)
   {
     printDashes();
-    for (uint column = 0; column < m_board.size(1); ++column)
+    for (uint column = 0; column < BOARD_SIZE_COLS; ++column)
     {
-      oss << "| " << PlayerToString(static_cast<Player>(m_board[row][column].item<int>())) << " ";
+      oss << "| " << PlayerToString(GetPlayerAtCoordinates(row, column)) << " ";
     }
     oss << "|" << std::endl;
   }
@@ -224,8 +313,10 @@ void EnvironmentTicTacToe::PrintBoard() const
 
 void EnvironmentTicTacToe::ResetEnvironment()
 {
-  m_board = torch::zeros({m_board.size(0), m_board.size(1)});
+  m_pieces        = {0, 0};
+  m_currentPlayer = Player::PLAYER_1;
   m_moveHistory.clear();
+  m_hash = ComputeHash();
 }
 
 std::string EnvironmentTicTacToe::PlayerToString(Player player) const
@@ -244,6 +335,28 @@ std::string EnvironmentTicTacToe::PlayerToString(Player player) const
 
 bool EnvironmentTicTacToe::BoardIsFull() const
 {
-  auto none = static_cast<int>(Player::PLAYER_NONE);
-  return torch::all(m_board != none).item<bool>();
+  return GetOccupiedCells() == FULL_BOARD;
+}
+
+uint16_t EnvironmentTicTacToe::GetOccupiedCells() const
+{
+  return m_pieces[0] | m_pieces[1];
+}
+
+uint64_t EnvironmentTicTacToe::ComputeHash() const
+{
+  // only used when the whole position is replaced, moves update the hash incrementally
+  uint64_t hash = PLAYER_KEYS[static_cast<size_t>(m_currentPlayer)];
+  for (uint row = 0; row < BOARD_SIZE_ROWS; ++row)
+  {
+    for (uint column = 0; column < BOARD_SIZE_COLS; ++column)
+    {
+      Player player = GetPlayerAtCoordinates(row, column);
+      if (player != Player::PLAYER_NONE)
+      {
+        hash ^= GetCellKey(row, column, player);
+      }
+    }
+  }
+  return hash;
 }
@@ -1,15 +1,24 @@
 #pragma once
 
-#include "Environment.hpp"
-#include "Move_TicTacToe.hpp"
+#include <array>
+#include <cstdint>
 
-class EnvironmentTicTacToe : public Environment
+#include "Environment.hpp"
+#include "Move.hpp"
+
+/**
+ * @brief Tic-tac-toe on a bitboard: every player has a 9-bit mask of the cells they occupy, bit (row * 3 + column).
+ * The game logic only uses bit operations, tensors are only created for the network in BoardToInput and GetBoard.
+ * The zobrist hash is updated with the key of the changed cell and the keys of the players to move on every move.
+ */
+class EnvironmentTicTacToe final : public Environment
 {
 private:
-  torch::Tensor m_board;
+  std::array<uint16_t, 2> m_pieces = {0, 0}; // cells occupied by player 1 and player 2
 
-  Player                             m_currentPlayer = Player::PLAYER_1;
-  std::vector<std::shared_ptr<Move>> m_moveHistory;
+  Player            m_currentPlayer = Player::PLAYER_1;
+  std::vector<Move> m_moveHistory;
+  uint64_t          m_hash = 0; // zobrist hash of the pieces and the current player
 
 public:
   EnvironmentTicTacToe();
@@ -23,22 +32,26 @@ public:
   void   SetCurrentPlayer(Player player) override;
   void   TogglePlayer() override;
 
-  void MakeMove(Move const & move) override;
+  void MakeMove(Move move) override;
   void UndoMove() override;
   bool IsValidMove(uint row, uint column) const override;
 
-  [[nodiscard]] std::vector<std::shared_ptr<Move>>         GetValidMoves() const override;
-  [[nodiscard]] std::vector<std::shared_ptr<Move>> const & GetMoveHistory() const override;
+  [[nodiscard]] MoveList                  GetValidMoves() const override;
+  [[nodiscard]] std::vector<Move> const & GetMoveHistory() const override;
 
   int GetRows() const override;
   int GetColumns() const override;
 
   Player GetPlayerAtCoordinates(uint row, uint column) const override;
 
-  torch::Tensor const & GetBoard() const override;
-  void                  SetBoard(torch::Tensor const & board, Player currentPlayer) override;
+  [[nodiscard]] torch::Tensor GetBoard() const override;
+  void                        SetBoard(torch::Tensor const & board, Player currentPlayer) override;
 
   [[nodiscard]] torch::Tensor BoardToInput() const override;
+  void                        BoardToInput(torch::Tensor & batch, int64_t index) const override;
+  int                         GetInputPlanes() const override;
+
+  uint64_t GetHash() const override;
 
   bool   IsTerminal() const override;
   Player GetWinner() const override;
@@ -50,5 +63,7 @@ public:
   std::string PlayerToString(Player player) const override;
 
 private:
-  bool BoardIsFull() const;
+  bool     BoardIsFull() const;
+  uint16_t GetOccupiedCells() const;
+  uint64_t ComputeHash() const;
 };
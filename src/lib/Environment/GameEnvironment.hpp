@@ -0,0 +1,49 @@
+#pragma once
+
+#include <concepts>
+#include <string>
+#include <vector>
+
+#include "Environment.hpp"
+
+/**
+ * @brief Requirements of an environment the search can be compiled for, mirroring the Environment interface.
+ * The search copies the environment once per thread, so it has to be copyable, which excludes the abstract Environment itself:
+ * use PolymorphicEnvironment to search an environment that is only known through the Environment interface.
+ * Environments that satisfy this concept should be final, so the search can call their functions directly.
+ */
+template<typename T>
+concept GameEnvironment = std::copy_constructible<T>
+                       && requires(T & environment, T const & constEnvironment, Move move, uint row, uint column, torch::Tensor const & board, torch::Tensor & batch, Player player) {
+                            { constEnvironment.GetCurrentPlayer() } -> std::same_as<Player>;
+                            environment.SetCurrentPlayer(player);
+                            environment.TogglePlayer();
+
+                            environment.MakeMove(move);
+                            environment.UndoMove();
+                            { constEnvironment.IsValidMove(row, column) } -> std::convertible_to<bool>;
+
+                            { constEnvironment.GetValidMoves() } -> std::convertible_to<MoveList>;
+                            { constEnvironment.GetMoveHistory() } -> std::convertible_to<std::vector<Move> const &>;
+
+                            { constEnvironment.GetRows() } -> std::convertible_to<int>;
+                            { constEnvironment.GetColumns() } -> std::convertible_to<int>;
+
+                            { constEnvironment.GetPlayerAtCoordinates(row, column) } -> std::same_as<Player>;
+
+                            { constEnvironment.GetBoard() } -> std::convertible_to<torch::Tensor>;
+                            environment.SetBoard(board, player);
+
+                            { constEnvironment.BoardToInput() } -> std::convertible_to<torch::Tensor>;
+                            constEnvironment.BoardToInput(batch, int64_t{0});
+                            { constEnvironment.GetInputPlanes() } -> std::convertible_to<int>;
+
+                            { constEnvironment.GetHash() } -> std::convertible_to<uint64_t>;
+
+                            { constEnvironment.IsTerminal() } -> std::convertible_to<bool>;
+                            { constEnvironment.GetWinner() } -> std::same_as<Player>;
+
+                            constEnvironment.PrintBoard();
+
+                            { constEnvironment.PlayerToString(player) } -> std::convertible_to<std::string>;
+                          };
@@ -0,0 +1,73 @@
+#include "Move.hpp"
+
+#include <stdexcept>
+
+Move::Move(uint row, uint column)
+  : m_row(uint8_t(row))
+  , m_column(uint8_t(column))
+{
+}
+
+std::pair<uint, uint> Move::GetCoordinates() const
+{
+  return std::make_pair(m_row, m_column);
+}
+
+uint Move::GetRow() const
+{
+  return m_row;
+}
+
+uint Move::GetColumn() const
+{
+  return m_column;
+}
+
+std::string Move::ToString() const
+{
+  return std::to_string(m_row) + ", " + std::to_string(m_column);
+}
+
+size_t Move::GetIndex(uint columns) const
+{
+  return m_row * columns + m_column;
+}
+
+void MoveList::push_back(Move move)
+{
+  if (m_size == CAPACITY)
+  {
+    throw std::length_error("Too many moves for a MoveList");
+  }
+  m_moves[m_size++] = move;
+}
+
+void MoveList::clear()
+{
+  m_size = 0;
+}
+
+size_t MoveList::size() const
+{
+  return m_size;
+}
+
+bool MoveList::empty() const
+{
+  return m_size == 0;
+}
+
+Move const & MoveList::operator[](size_t index) const
+{
+  return m_moves[index];
+}
+
+Move const * MoveList::begin() const
+{
+  return m_moves.data();
+}
+
+Move const * MoveList::end() const
+{
+  return m_moves.data() + m_size;
+}
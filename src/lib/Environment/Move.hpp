@@ -2,19 +2,57 @@
 
 #include <sys/types.h>
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <utility>
 
+/**
+ * @brief A move on the board, stored as its coordinates in two bytes so it can be copied around by value.
+ * The prior probability of a move isn't part of it: the search keeps it in the statistics of the node the move leads to.
+ */
 class Move
 {
+private:
+  uint8_t m_row    = 0;
+  uint8_t m_column = 0;
+
+public:
+  Move() = default;
+  Move(uint row, uint column);
+
+  std::pair<uint, uint> GetCoordinates() const;
+  uint                  GetRow() const;
+  uint                  GetColumn() const;
+  std::string           ToString() const;
+  size_t                GetIndex(uint columns) const; // index of the move in the policy output of a board with this many columns
+
+  bool operator==(Move const & other) const = default;
+};
+
+static_assert(std::is_trivially_copyable_v<Move> && sizeof(Move) == 2, "Moves are copied by value");
+
+/**
+ * @brief The valid moves of a position, stored in a fixed-capacity buffer so generating them doesn't allocate.
+ */
+class MoveList
+{
+public:
+  static size_t constexpr CAPACITY = 256; // more than the amount of cells of the boards the environments use
+
+private:
+  std::array<Move, CAPACITY> m_moves;
+  uint16_t                   m_size = 0;
+
 public:
-  virtual ~Move() = default;
-
-  virtual std::pair<uint, uint> GetCoordinates() const                      = 0;
-  virtual uint                  GetRow() const                              = 0;
-  virtual uint                  GetColumn() const                           = 0;
-  virtual float                 GetPriorProbability() const                 = 0;
-  virtual void                  SetPriorProbability(float priorProbability) = 0;
-  virtual std::string           ToString() const                            = 0;
-  virtual size_t                GetIndex() const                            = 0;
-};
\ No newline at end of file
+  void push_back(Move move);
+  void clear();
+
+  size_t size() const;
+  bool   empty() const;
+
+  Move const & operator[](size_t index) const;
+  Move const * begin() const;
+  Move const * end() const;
+};
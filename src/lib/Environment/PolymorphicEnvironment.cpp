@@ -0,0 +1,130 @@
+#include "PolymorphicEnvironment.hpp"
+
+PolymorphicEnvironment::PolymorphicEnvironment(Environment const & environment)
+  : m_environment(environment.Clone())
+{
+}
+
+PolymorphicEnvironment::PolymorphicEnvironment(PolymorphicEnvironment const & other)
+  : m_environment(other.m_environment->Clone())
+{
+}
+
+PolymorphicEnvironment & PolymorphicEnvironment::operator=(PolymorphicEnvironment const & other)
+{
+  if (this != &other)
+  {
+    m_environment = other.m_environment->Clone();
+  }
+  return *this;
+}
+
+Environment const & PolymorphicEnvironment::Get() const
+{
+  return *m_environment;
+}
+
+Player PolymorphicEnvironment::GetCurrentPlayer() const
+{
+  return m_environment->GetCurrentPlayer();
+}
+
+void PolymorphicEnvironment::SetCurrentPlayer(Player player)
+{
+  m_environment->SetCurrentPlayer(player);
+}
+
+void PolymorphicEnvironment::TogglePlayer()
+{
+  m_environment->TogglePlayer();
+}
+
+void PolymorphicEnvironment::MakeMove(Move move)
+{
+  m_environment->MakeMove(move);
+}
+
+void PolymorphicEnvironment::UndoMove()
+{
+  m_environment->UndoMove();
+}
+
+bool PolymorphicEnvironment::IsValidMove(uint row, uint column) const
+{
+  return m_environment->IsValidMove(row, column);
+}
+
+MoveList PolymorphicEnvironment::GetValidMoves() const
+{
+  return m_environment->GetValidMoves();
+}
+
+std::vector<Move> const & PolymorphicEnvironment::GetMoveHistory() const
+{
+  return m_environment->GetMoveHistory();
+}
+
+int PolymorphicEnvironment::GetRows() const
+{
+  return m_environment->GetRows();
+}
+
+int PolymorphicEnvironment::GetColumns() const
+{
+  return m_environment->GetColumns();
+}
+
+Player PolymorphicEnvironment::GetPlayerAtCoordinates(uint row, uint column) const
+{
+  return m_environment->GetPlayerAtCoordinates(row, column);
+}
+
+torch::Tensor PolymorphicEnvironment::GetBoard() const
+{
+  return m_environment->GetBoard();
+}
+
+void PolymorphicEnvironment::SetBoard(torch::Tensor const & board, Player currentPlayer)
+{
+  m_environment->SetBoard(board, currentPlayer);
+}
+
+torch::Tensor PolymorphicEnvironment::BoardToInput() const
+{
+  return m_environment->BoardToInput();
+}
+
+void PolymorphicEnvironment::BoardToInput(torch::Tensor & batch, int64_t index) const
+{
+  m_environment->BoardToInput(batch, index);
+}
+
+int PolymorphicEnvironment::GetInputPlanes() const
+{
+  return m_environment->GetInputPlanes();
+}
+
+uint64_t PolymorphicEnvironment::GetHash() const
+{
+  return m_environment->GetHash();
+}
+
+bool PolymorphicEnvironment::IsTerminal() const
+{
+  return m_environment->IsTerminal();
+}
+
+Player PolymorphicEnvironment::GetWinner() const
+{
+  return m_environment->GetWinner();
+}
+
+void PolymorphicEnvironment::PrintBoard() const
+{
+  m_environment->PrintBoard();
+}
+
+std::string PolymorphicEnvironment::PlayerToString(Player player) const
+{
+  return m_environment->PlayerToString(player);
+}
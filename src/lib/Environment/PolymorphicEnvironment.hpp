@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+
+#include "Environment.hpp"
+
+/**
+ * @brief Copyable wrapper around an environment that is only known through the Environment interface.
+ * Every call goes through the virtual functions of the wrapped environment, copies clone it.
+ * This lets the search run on any Environment, at the cost of the indirect calls the concrete environments avoid.
+ */
+class PolymorphicEnvironment
+{
+private:
+  std::unique_ptr<Environment> m_environment;
+
+public:
+  PolymorphicEnvironment(Environment const & environment); // implicit, so an Environment can be passed wherever the search expects its environment
+  ~PolymorphicEnvironment() = default;
+
+  PolymorphicEnvironment(PolymorphicEnvironment const & other);
+  PolymorphicEnvironment & operator=(PolymorphicEnvironment const & other);
+
+  Environment const & Get() const;
+
+  Player GetCurrentPlayer() const;
+  void   SetCurrentPlayer(Player player);
+  void   TogglePlayer();
+
+  void MakeMove(Move move);
+  void UndoMove();
+  bool IsValidMove(uint row, uint column) const;
+
+  [[nodiscard]] MoveList                  GetValidMoves() const;
+  [[nodiscard]] std::vector<Move> const & GetMoveHistory() const;
+
+  int GetRows() const;
+  int GetColumns() const;
+
+  Player GetPlayerAtCoordinates(uint row, uint column) const;
+
+  [[nodiscard]] torch::Tensor GetBoard() const;
+  void                        SetBoard(torch::Tensor const & board, Player currentPlayer);
+
+  [[nodiscard]] torch::Tensor BoardToInput() const;
+  void                        BoardToInput(torch::Tensor & batch, int64_t index) const;
+  int                         GetInputPlanes() const;
+
+  uint64_t GetHash() const;
+
+  bool   IsTerminal() const;
+  Player GetWinner() const;
+
+  void PrintBoard() const;
+
+  std::string PlayerToString(Player player) const;
+};
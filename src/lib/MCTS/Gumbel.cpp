@@ -0,0 +1,63 @@
+#include "Gumbel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+auto constexpr C_VISIT = 50.0F; // visit count offset of the Q-value scale
+auto constexpr C_SCALE = 1.0F;  // Q-value scale: higher -> the search results weigh more than the prior
+} // namespace
+
+float ScaleQValue(float qValue, uint maxVisitCount)
+{
+  // Q-values are normalized from [-1, 1] to [0, 1], like the logits they only matter relative to each other
+  return (C_VISIT + (float)maxVisitCount) * C_SCALE * (qValue + 1.0F) / 2.0F;
+}
+
+float GetMixedValue(std::span<float const> priors, std::span<float const> qValues, std::span<uint const> visitCounts, float rootValue)
+{
+  float visitSum    = 0.0F;
+  float priorSum    = 0.0F;
+  float weightedSum = 0.0F;
+  for (size_t i = 0; i < priors.size(); i++)
+  {
+    if (visitCounts[i] > 0)
+    {
+      visitSum += (float)visitCounts[i];
+      priorSum += priors[i];
+      weightedSum += priors[i] * qValues[i];
+    }
+  }
+  if (visitSum == 0.0F || priorSum <= 0.0F)
+  {
+    return rootValue;
+  }
+  return (rootValue + visitSum * weightedSum / priorSum) / (1.0F + visitSum);
+}
+
+std::vector<float> GetImprovedPolicy(std::span<float const> logits, std::span<float const> completedQValues, uint maxVisitCount)
+{
+  std::vector<float> policy(logits.size());
+  for (size_t i = 0; i < logits.size(); i++)
+  {
+    policy[i] = logits[i] + ScaleQValue(completedQValues[i], maxVisitCount);
+  }
+  if (policy.empty())
+  {
+    return policy;
+  }
+  // softmax, shifted by the maximum so the exponentials can't overflow
+  float maximum = *std::max_element(policy.begin(), policy.end());
+  float sum     = 0.0F;
+  for (auto & probability: policy)
+  {
+    probability = std::exp(probability - maximum);
+    sum += probability;
+  }
+  for (auto & probability: policy)
+  {
+    probability /= sum;
+  }
+  return policy;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <span>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * @brief Transforms a Q-value in [-1, 1] so it can be added to the logits of the root policy.
+ * The weight of the Q-value grows with the visit count of the most visited root child, as in Gumbel AlphaZero.
+ */
+float ScaleQValue(float qValue, uint maxVisitCount);
+
+/**
+ * @brief Estimates the value of the root for its unvisited children, by mixing the network value of the root
+ * with the prior-weighted Q-values of the visited children.
+ */
+float GetMixedValue(std::span<float const> priors, std::span<float const> qValues, std::span<uint const> visitCounts, float rootValue);
+
+/**
+ * @brief The improved policy softmax(logits + ScaleQValue(completedQ)), used as policy target instead of the visit counts.
+ */
+std::vector<float> GetImprovedPolicy(std::span<float const> logits, std::span<float const> completedQValues, uint maxVisitCount);
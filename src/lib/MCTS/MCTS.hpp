@@ -1,10 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
-#include "../Environment/Environment.hpp"
+#include "../Environment/GameEnvironment.hpp"
+#include "../Environment/PolymorphicEnvironment.hpp"
+#include "../NeuralNetwork/EvaluationQueue.hpp"
 #include "../NeuralNetwork/NeuralNetworkInterface.hpp"
 #include "Node.hpp"
+#include "NodeArena.hpp"
+#include "TranspositionTable.hpp"
 
 struct DirichletNoiseOptions
 {
@@ -14,30 +22,143 @@ struct DirichletNoiseOptions
   float dirichletFraction; // fraction of the dirichlet noise to add to the prior probabilities
 };
 
+struct SearchOptions
+{
+  uint batchSize  = 1; // amount of leaf nodes to collect before evaluating them with a single network call
+  uint numThreads = 1; // amount of threads that run simulations on the same tree at the same time
+
+  bool asynchronous = false; // keep selecting while the network runs, batchSize is then the amount of pending evaluations per thread
+
+  bool rootParallel = false; // give every thread its own tree instead of sharing one, the root statistics are merged after the search
+
+  uint transpositionTableSize = 0; // amount of positions in the transposition table, 0 disables transpositions
+
+  uint maxNodes = 0; // node budget of the tree, the least visited subtrees are pruned when it is reached, 0 for no limit
+
+  bool useSolver = false; // prove wins, losses and draws, and stop searching proven subtrees
+
+  bool useGumbel             = false; // choose the root move with gumbel-top-k sampling and sequential halving instead of dirichlet noise and visit counts
+  uint gumbelConsideredMoves = 16;    // amount of root moves sampled for sequential halving
+
+  bool stopEarly      = false; // stop the search once the most visited root move can't be overtaken in the remaining simulations
+  uint minSimulations = 0;     // amount of simulations to run before the search is allowed to stop early
+};
+
+struct SearchStatistics
+{
+  uint     simulations       = 0;    // simulations run, lower than requested when the search stopped early
+  uint     maxDepth          = 0;    // depth of the deepest leaf node reached by a simulation
+  float    meanLeafDepth     = 0.0F; // average depth of the leaf nodes reached by the simulations
+  uint32_t nodeCount         = 0;    // nodes in the tree after the search
+  uint32_t peakNodeCount     = 0;    // highest amount of nodes in the tree during the search, before it was pruned
+  uint     expansions        = 0;    // nodes expanded during the search
+  uint     terminalHits      = 0;    // simulations that ended in a terminal or proven node, without running the network
+  uint     transpositionHits = 0;    // leaf nodes expanded with an evaluation from the transposition table, without running the network
+  float    wallTime          = 0.0F; // seconds the search took
+};
+
+/**
+ * @brief Monte Carlo tree search, compiled for the concrete environment type of a game so its functions can be called directly.
+ * The search is instantiated for every environment in MCTS.cpp.
+ * An environment that is only known through the Environment interface is searched through PolymorphicEnvironment.
+ */
+template<GameEnvironment Env>
 class MCTS
 {
 private:
-  std::shared_ptr<Node> m_root;
-  DirichletNoiseOptions m_dirichletNoiseOptions;
+  std::unique_ptr<NodeArena>          m_arena;              // storage of the nodes of the current tree
+  std::unique_ptr<NodeArena>          m_spareArena;         // a reused subtree is compacted into this arena, after which the two are swapped
+  std::unique_ptr<TranspositionTable> m_transpositionTable; // shared statistics of identical positions, nullptr if disabled
+  std::unique_ptr<Env>                m_rootEnvironment;    // every search thread works on its own copy of this environment
+  uint32_t                            m_root = NO_NODE;
+  DirichletNoiseOptions               m_dirichletNoiseOptions;
+  SearchOptions                       m_searchOptions;
+  std::vector<std::unique_ptr<MCTS>>  m_rootSearches;           // trees of the other threads when root parallelism is used
+  std::vector<uint>                   m_mergedRootVisits;       // visits of the root children summed over all root-parallel trees, empty otherwise
+  uint32_t                            m_gumbelChoice = NO_NODE; // offset of the root child chosen by the last gumbel search
+  float                               m_rootValue    = 0.0F;    // value of the root from the perspective of its player to move, used by the gumbel search
+  SearchStatistics                    m_statistics;             // statistics of the last search
+  uint64_t                            m_searchCount  = 0;       // amount of searches run by this tree, part of the random streams of the search threads
+
+  // counted by the search threads while the search runs, collected in m_statistics afterwards
+  std::atomic<uint>     m_savedEvaluations  = 0; // network evaluations skipped because the leaf was terminal or proven
+  std::atomic<uint>     m_expansions        = 0;
+  std::atomic<uint>     m_leafCount         = 0;
+  std::atomic<uint64_t> m_leafDepthSum      = 0;
+  std::atomic<uint>     m_maxLeafDepth      = 0;
+  std::atomic<uint>     m_transpositionHits = 0;
 
 public:
-  MCTS(std::shared_ptr<Node> root, DirichletNoiseOptions const & dirichletNoiseOptions);
+  MCTS(Env const & environment, DirichletNoiseOptions const & dirichletNoiseOptions, SearchOptions const & searchOptions = {});
   ~MCTS() = default;
 
-  void RunSimulations(uint numSimulations, NeuralNetworkInterface & network);
+  SearchStatistics         RunSimulations(uint numSimulations, NeuralNetworkInterface & network);
+  SearchStatistics const & GetStatistics() const;
+  uint                     GetSimulationsRun() const;
+  uint                     GetSavedEvaluations() const;
+  uint                     GetPeakNodes() const;
+
+  Node const &          GetRoot() const;
+  Env const &           GetRootEnvironment() const;
+  std::span<Node const> GetChildren(Node const & node) const;
+  Move                  GetBestMove(bool stochasticSearch) const;
+  std::vector<float>    GetPolicyTarget() const;    // training target for the policy, one probability per root child
+  std::vector<uint>     GetRootVisitCounts() const; // visits of the root children, summed over all trees after a root-parallel search
 
-  std::shared_ptr<Node> GetRoot() const;
-  std::shared_ptr<Move> GetBestMove(bool stochasticSearch) const;
+  void EnableDirichletNoise(bool enable);
+  bool IsDirichletNoiseEnabled() const;
+  void ResetRoot(Env const & environment);
+  bool AdvanceRoot(Move move);
 
 private:
-  static std::shared_ptr<Node> Select(std::shared_ptr<Node> const & root);
-  static float                 Expand(std::shared_ptr<Node> const & node, NeuralNetworkInterface & network); // also does step 3: evaluation
-  static void                  Backpropagate(std::shared_ptr<Node> const & node, float reward);
+  void PrepareRoot(NeuralNetworkInterface & network);
+  void RunSimulationsParallel(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, EvaluationQueue * evaluationQueue);
+  void RunSimulationsRootParallel(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, EvaluationQueue * evaluationQueue);
+  void RunSimulationsWorker(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, EvaluationQueue * evaluationQueue, bool showProgress);
+  void RunSimulationsSequential(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, Env & environment, bool showProgress);
+  void RunSimulationsBatched(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, Env & environment, bool showProgress);
+  void RunSimulationsAsynchronous(std::atomic<uint> & simulations, uint numSimulations, EvaluationQueue & evaluationQueue, Env & environment, bool showProgress);
+
+  uint32_t Select(uint32_t root, Env & environment);                                              // makes the moves of the selected path in the environment
+  float    Expand(uint32_t nodeIndex, Env const & environment, NeuralNetworkInterface & network); // also does step 3: evaluation
+  void     Backpropagate(uint32_t nodeIndex, float reward);
+  void     ReturnToRoot(uint32_t nodeIndex, Env & environment) const; // undoes the moves made by Select
+
+  void CreateChildren(uint32_t nodeIndex, MoveList const & validMoves, torch::Tensor const & policyOutput);
+  void StorePosition(uint32_t nodeIndex, Env const & environment);
+
+  std::optional<float> GetKnownValue(uint32_t nodeIndex, Env const & environment);
+  bool                 TryProve(uint32_t nodeIndex);
+  bool                 IsSolved() const;
+  bool                 ShouldStop(uint simulations, uint numSimulations) const;
+  bool                 BestMoveIsDecided(uint simulations, uint numSimulations) const;
+  bool                 IsTreeFull() const;
+  bool                 PruneTreeIfFull(uint simulations, uint numSimulations);
 
-  static uint GetTreeDepth(Node * root);
+  std::optional<float> EvaluateFromTranspositionTable(uint32_t nodeIndex, Env const & environment);
+  void                 StoreInTranspositionTable(uint32_t nodeIndex, torch::Tensor const & policyOutput, float value);
 
-  std::shared_ptr<Move> GetBestMoveStochastic() const;
-  std::shared_ptr<Move> GetBestMoveDeterministic() const;
+  void MergeRootStatistics(MCTS const & other);
+  void ResetSearchCounters();
+  void MergeSearchCounters(MCTS const & other);
+
+  uint               RunGumbelSearch(uint numSimulations, NeuralNetworkInterface & network);
+  void               RunSimulationFromChild(uint32_t childIndex, Env & environment, NeuralNetworkInterface & network);
+  std::vector<float> GetRootLogits() const;
+  std::vector<float> GetCompletedQValues() const;
+  uint               GetMaxVisitCount() const;
+
+  void AddVirtualLoss(uint32_t nodeIndex);
+  void RemoveVirtualLoss(uint32_t nodeIndex);
+
+  static uint32_t CopySubtree(NodeArena const & source, uint32_t root, NodeArena & destination, uint32_t maxNodes = NO_NODE);
+
+  Move               GetBestMoveStochastic() const;
+  Move               GetBestMoveDeterministic() const;
+  std::vector<float> GetVisitPolicy() const; // normalized visit counts of the root children, the priors if there are no visits
+
+  void AddDirichletNoiseToRoot();
+};
 
-  void AddDirichletNoiseToRoot() const;
-};
\ No newline at end of file
+// an Environment that isn't a GameEnvironment itself is searched through its virtual interface
+MCTS(Environment const & environment, DirichletNoiseOptions const & dirichletNoiseOptions, SearchOptions const & searchOptions = {}) -> MCTS<PolymorphicEnvironment>;
@@ -0,0 +1,1347 @@
+#include "MCTS.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <queue>
+#include <thread>
+#include <utility>
+
+#include "../../lib/Logging/Logger.hpp"
+#include "../../lib/NeuralNetwork/Device.hpp"
+#include "../../lib/Utilities/RandomGenerator.hpp"
+#include "../../lib/Utilities/tqdm.hpp"
+#include "Gumbel.hpp"
+#include "Puct.hpp"
+
+template<GameEnvironment Env>
+MCTS<Env>::MCTS(Env const & environment, DirichletNoiseOptions const & dirichletNoiseOptions, SearchOptions const & searchOptions)
+  : m_arena(std::make_unique<NodeArena>())
+  , m_spareArena(std::make_unique<NodeArena>())
+  , m_dirichletNoiseOptions(dirichletNoiseOptions)
+  , m_searchOptions(searchOptions)
+{
+  if (m_searchOptions.batchSize == 0)
+  {
+    throw std::runtime_error("Search batch size must be at least 1");
+  }
+  if (m_searchOptions.numThreads == 0)
+  {
+    throw std::runtime_error("Amount of search threads must be at least 1");
+  }
+  if (m_searchOptions.useGumbel && (m_searchOptions.numThreads > 1 || m_searchOptions.batchSize > 1 || m_searchOptions.rootParallel))
+  {
+    LWARN << "The gumbel search runs its simulations one by one on a single thread, numThreads, batchSize and rootParallel are ignored";
+  }
+  if (m_searchOptions.transpositionTableSize > 0)
+  {
+    m_transpositionTable = std::make_unique<TranspositionTable>(m_searchOptions.transpositionTableSize);
+  }
+  ResetRoot(environment);
+}
+
+template<GameEnvironment Env>
+SearchStatistics MCTS<Env>::RunSimulations(uint numSimulations, NeuralNetworkInterface & network)
+{
+  LINFO << "Running " << numSimulations << " simulations";
+
+  auto start = std::chrono::steady_clock::now();
+  m_statistics = SearchStatistics{.peakNodeCount = m_arena->Size()};
+  ResetSearchCounters();
+  m_mergedRootVisits.clear();
+  m_searchCount++;
+
+  if (!m_searchOptions.useGumbel)
+  {
+    PrepareRoot(network); // the gumbel search doesn't use dirichlet noise, the gumbel noise replaces it
+  }
+
+  // run simulations
+  std::atomic<uint> simulations = 0;
+  // in asynchronous mode all search threads send their leaf nodes to the same queue, which batches them for the network
+  // the gumbel search evaluates its leaf nodes itself, so it doesn't start the queue and its evaluator thread
+  std::unique_ptr<EvaluationQueue> evaluationQueue;
+  if (m_searchOptions.asynchronous && !m_searchOptions.useGumbel)
+  {
+    evaluationQueue = std::make_unique<EvaluationQueue>(network, m_searchOptions.batchSize * m_searchOptions.numThreads);
+  }
+  try
+  {
+    if (m_searchOptions.useGumbel)
+    {
+      simulations.store(RunGumbelSearch(numSimulations, network));
+    }
+    else if (m_searchOptions.numThreads > 1 && m_searchOptions.rootParallel)
+    {
+      RunSimulationsRootParallel(simulations, numSimulations, network, evaluationQueue.get());
+    }
+    else
+    {
+      // the threads stop when the tree reaches its node budget, after it is pruned they continue with the remaining simulations
+      do
+      {
+        if (m_searchOptions.numThreads > 1)
+        {
+          RunSimulationsParallel(simulations, numSimulations, network, evaluationQueue.get());
+        }
+        else
+        {
+          RunSimulationsWorker(simulations, numSimulations, network, evaluationQueue.get(), true);
+        }
+      } while (PruneTreeIfFull(std::min(simulations.load(), numSimulations), numSimulations));
+    }
+  }
+  catch (std::exception const & e)
+  {
+    LWARN << "Exception while running simulations: " << e.what();
+    throw std::runtime_error("Exception while running simulations: " + std::string(e.what()));
+  }
+  uint leafCount                 = m_leafCount.load(std::memory_order_relaxed);
+  m_statistics.simulations       = std::min(simulations.load(), numSimulations);
+  m_statistics.maxDepth          = m_maxLeafDepth.load(std::memory_order_relaxed);
+  m_statistics.meanLeafDepth     = leafCount > 0 ? (float)m_leafDepthSum.load(std::memory_order_relaxed) / (float)leafCount : 0.0F;
+  m_statistics.nodeCount         = m_arena->Size();
+  m_statistics.peakNodeCount     = std::max(m_statistics.peakNodeCount, m_statistics.nodeCount);
+  m_statistics.expansions        = m_expansions.load(std::memory_order_relaxed);
+  m_statistics.terminalHits      = m_savedEvaluations.load(std::memory_order_relaxed);
+  m_statistics.transpositionHits = m_transpositionHits.load(std::memory_order_relaxed);
+  m_statistics.wallTime          = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+  LINFO << "Finished running " << m_statistics.simulations << " of " << numSimulations << " simulations in " << m_statistics.wallTime << "s ("
+        << (float)m_statistics.simulations / m_statistics.wallTime << " simulations/s on " << m_searchOptions.numThreads << " thread(s), "
+        << (m_searchOptions.rootParallel ? "root" : "tree") << " parallel)";
+  LINFO << "Tree depth: " << m_statistics.maxDepth << " (mean leaf depth " << m_statistics.meanLeafDepth << "), nodes: " << m_statistics.nodeCount
+        << " (peak " << m_statistics.peakNodeCount << ", " << m_statistics.expansions << " expanded during this search), node memory: "
+        << (m_arena->GetMemoryUsage() + m_spareArena->GetMemoryUsage()) / (1024 * 1024) << " MiB";
+  if (IsSolved())
+  {
+    LINFO << "Search stopped early, the root position is proven with value " << *GetRoot().GetProvenValue();
+  }
+  LINFO << "Resolved " << m_statistics.terminalHits << " terminal leaf node(s) without running the network";
+  if (m_transpositionTable)
+  {
+    LINFO << "Transposition table: " << m_statistics.transpositionHits << " hits during this search, " << m_transpositionTable->GetReplaced()
+          << " replaced positions";
+  }
+  if (evaluationQueue)
+  {
+    auto statistics = evaluationQueue->GetStatistics();
+    LINFO << "Evaluation queue: " << statistics.evaluations << " positions in " << statistics.batches << " batches, network busy for "
+          << statistics.busyTime << "s and idle for " << statistics.idleTime << "s, search threads waited " << statistics.waitTime << "s";
+  }
+  return m_statistics;
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::PrepareRoot(NeuralNetworkInterface & network)
+{
+  try
+  {
+    if (m_dirichletNoiseOptions.enable)
+    {
+      if (GetRoot().IsLeaf())
+      {
+        Expand(m_root, *m_rootEnvironment, network); // expand the root node once, so we can add dirichlet noise to it
+      }
+      AddDirichletNoiseToRoot();
+    }
+  }
+  catch (std::exception const & e)
+  {
+    LWARN << "Exception while adding dirichlet noise to root: " << e.what();
+    throw std::runtime_error("Exception while adding dirichlet noise to root: " + std::string(e.what()));
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationsParallel(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, EvaluationQueue * evaluationQueue)
+{
+  // tree parallelism: all threads work on the same tree, the virtual loss makes them select different paths
+  std::vector<std::thread> threads;
+  std::exception_ptr       exception = nullptr;
+  std::mutex               exceptionMutex;
+
+  // the search threads draw from their own streams of the game and this search, the stream of the game itself belongs to the calling thread
+  uint64_t gameID = RandomGenerator::gameID;
+  threads.reserve(m_searchOptions.numThreads);
+  for (uint i = 0; i < m_searchOptions.numThreads; i++)
+  {
+    threads.emplace_back(
+      [&, i]()
+      {
+        RandomGenerator::SetStream(gameID, i + 1, m_searchCount);
+        try
+        {
+          RunSimulationsWorker(simulations, numSimulations, network, evaluationQueue, i == 0);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(exceptionMutex);
+          if (exception == nullptr)
+          {
+            exception = std::current_exception();
+          }
+          // make the other threads stop as well
+          simulations.store(numSimulations);
+        }
+      });
+  }
+  for (auto & thread: threads)
+  {
+    thread.join();
+  }
+
+  if (exception != nullptr)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationsRootParallel(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, EvaluationQueue * evaluationQueue)
+{
+  // root parallelism: every thread searches its own tree from the same position, without sharing any nodes
+  uint numSearches = m_searchOptions.numThreads;
+  if (GetRoot().IsLeaf())
+  {
+    Expand(m_root, *m_rootEnvironment, network); // the root statistics of the other trees are merged into the children of this root
+  }
+
+  SearchOptions searchOptions = m_searchOptions;
+  searchOptions.numThreads    = 1;
+  searchOptions.rootParallel  = false;
+  m_rootSearches.resize(numSearches - 1);
+  for (auto & search: m_rootSearches)
+  {
+    if (search == nullptr)
+    {
+      search = std::make_unique<MCTS>(*m_rootEnvironment, m_dirichletNoiseOptions, searchOptions);
+    }
+    else
+    {
+      search->ResetRoot(*m_rootEnvironment);
+    }
+    // every tree draws its own dirichlet noise, done before the threads start so the noise doesn't depend on their timing
+    search->ResetSearchCounters();
+    search->PrepareRoot(network);
+  }
+
+  // the first thread searches this tree, the others search the trees in m_rootSearches
+  std::vector<std::atomic<uint>> searchSimulations(numSearches);
+  std::vector<uint>              searchShares(numSearches);
+  std::vector<std::thread>       threads;
+  std::exception_ptr             exception = nullptr;
+  std::mutex                     exceptionMutex;
+  uint64_t                       gameID = RandomGenerator::gameID; // the threads draw from their own streams of the game
+
+  threads.reserve(numSearches);
+  for (uint i = 0; i < numSearches; i++)
+  {
+    searchShares[i] = numSimulations / numSearches + (i < numSimulations % numSearches ? 1 : 0);
+    threads.emplace_back(
+      [&, i]()
+      {
+        RandomGenerator::SetStream(gameID, i + 1, m_searchCount);
+        try
+        {
+          // every tree is searched by a single thread, so it can be pruned without stopping the other threads
+          MCTS & search = i == 0 ? *this : *m_rootSearches[i - 1];
+          do
+          {
+            search.RunSimulationsWorker(searchSimulations[i], searchShares[i], network, evaluationQueue, i == 0);
+          } while (search.PruneTreeIfFull(std::min(searchSimulations[i].load(), searchShares[i]), searchShares[i]));
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(exceptionMutex);
+          if (exception == nullptr)
+          {
+            exception = std::current_exception();
+          }
+          // make the other threads stop as well
+          for (uint j = 0; j < numSearches; j++)
+          {
+            searchSimulations[j].store(searchShares[j]);
+          }
+        }
+      });
+  }
+  for (auto & thread: threads)
+  {
+    thread.join();
+  }
+
+  if (exception != nullptr)
+  {
+    std::rethrow_exception(exception);
+  }
+
+  uint simulationsRun = 0;
+  for (uint i = 0; i < numSearches; i++)
+  {
+    simulationsRun += std::min(searchSimulations[i].load(), searchShares[i]);
+  }
+  simulations.store(simulationsRun);
+  m_mergedRootVisits.clear();
+  for (auto const & child: GetChildren(GetRoot()))
+  {
+    m_mergedRootVisits.emplace_back(child.GetVisitCount());
+  }
+  for (auto const & search: m_rootSearches)
+  {
+    MergeRootStatistics(*search);
+    MergeSearchCounters(*search);
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::MergeRootStatistics(MCTS const & other)
+{
+  // both roots were expanded from the same position, so their children are the same moves in the same order.
+  // the visits are kept apart from the nodes: the subtrees of this tree only hold its own visits, and have to stay consistent when they are reused
+  auto otherChildren = other.GetChildren(other.GetRoot());
+  if (otherChildren.size() != m_mergedRootVisits.size())
+  {
+    LWARN << "Cannot merge the root statistics of trees with different children";
+    return;
+  }
+  for (size_t i = 0; i < m_mergedRootVisits.size(); i++)
+  {
+    m_mergedRootVisits[i] += otherChildren[i].GetVisitCount();
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::ResetSearchCounters()
+{
+  m_savedEvaluations.store(0, std::memory_order_relaxed);
+  m_expansions.store(0, std::memory_order_relaxed);
+  m_leafCount.store(0, std::memory_order_relaxed);
+  m_leafDepthSum.store(0, std::memory_order_relaxed);
+  m_maxLeafDepth.store(0, std::memory_order_relaxed);
+  m_transpositionHits.store(0, std::memory_order_relaxed);
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::MergeSearchCounters(MCTS const & other)
+{
+  // called after the threads have finished, so the counters of the other tree don't change anymore
+  m_savedEvaluations.fetch_add(other.m_savedEvaluations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  m_expansions.fetch_add(other.m_expansions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  m_leafCount.fetch_add(other.m_leafCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  m_leafDepthSum.fetch_add(other.m_leafDepthSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  m_maxLeafDepth.store(std::max(m_maxLeafDepth.load(std::memory_order_relaxed), other.m_maxLeafDepth.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+  m_transpositionHits.fetch_add(other.m_transpositionHits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+template<GameEnvironment Env>
+uint MCTS<Env>::RunGumbelSearch(uint numSimulations, NeuralNetworkInterface & network)
+{
+  // Gumbel AlphaZero: sample the root moves to consider without replacement with the gumbel-top-k trick,
+  // then divide the simulations over them with sequential halving. The search runs on a single thread.
+  Env environment = *m_rootEnvironment;
+  if (GetRoot().IsLeaf())
+  {
+    // the value of a node is from the perspective of the player that moved into it, so it is negated for the player to move
+    m_rootValue = -Expand(m_root, environment, network);
+  }
+  else
+  {
+    // a reused root: its network value isn't known anymore, estimate it from the visited children
+    float valueSum   = 0.0F;
+    uint  visitCount = 0;
+    for (auto const & child: GetChildren(GetRoot()))
+    {
+      valueSum += child.GetValue();
+      visitCount += child.GetVisitCount();
+    }
+    m_rootValue = visitCount > 0 ? valueSum / (float)visitCount : 0.0F;
+  }
+  m_gumbelChoice = NO_NODE;
+
+  uint32_t childCount = GetRoot().GetChildCount();
+  if (childCount == 0)
+  {
+    return 0;
+  }
+
+  auto logits = GetRootLogits();
+  auto gumbel = RandomGenerator::SampleFromGumbel(childCount);
+  // candidates are offsets of the root children, they stay valid when the tree is pruned
+  std::vector<uint32_t> candidates(childCount);
+  std::iota(candidates.begin(), candidates.end(), 0);
+  auto sortByScore = [&](bool includeQValues)
+  {
+    auto               completedQValues = GetCompletedQValues();
+    uint               maxVisitCount    = GetMaxVisitCount();
+    std::vector<float> scores(childCount);
+    for (uint32_t i = 0; i < childCount; i++)
+    {
+      scores[i] = gumbel[i] + logits[i] + (includeQValues ? ScaleQValue(completedQValues[i], maxVisitCount) : 0.0F);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [&scores](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+  };
+
+  // the top k moves of gumbel + logits are a sample without replacement from the policy
+  sortByScore(false);
+  candidates.resize(std::min(m_searchOptions.gumbelConsideredMoves, childCount));
+
+  uint phases      = candidates.size() > 1 ? (uint)std::ceil(std::log2((float)candidates.size())) : 1;
+  uint simulations = 0;
+  for (uint phase = 0; phase < phases && simulations < numSimulations && !IsSolved(); phase++)
+  {
+    uint simulationsPerCandidate = std::max(1U, numSimulations / (phases * (uint)candidates.size()));
+    if (phase == phases - 1)
+    {
+      // the last phase gets what the rounding of the earlier phases left over, so the whole budget is searched
+      simulationsPerCandidate = std::max(1U, (numSimulations - simulations + (uint)candidates.size() - 1) / (uint)candidates.size());
+    }
+    for (uint32_t candidate: candidates)
+    {
+      for (uint i = 0; i < simulationsPerCandidate && simulations < numSimulations; i++)
+      {
+        RunSimulationFromChild(GetRoot().GetFirstChild() + candidate, environment, network);
+        simulations++;
+        PruneTreeIfFull(simulations, numSimulations);
+      }
+    }
+    // only the better half of the candidates continues to the next phase
+    sortByScore(true);
+    candidates.resize((candidates.size() + 1) / 2);
+  }
+  sortByScore(true);
+  m_gumbelChoice = candidates.front();
+  return simulations;
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationFromChild(uint32_t childIndex, Env & environment, NeuralNetworkInterface & network)
+{
+  // the root move is chosen by sequential halving, below it the search selects with PUCT as usual
+  environment.MakeMove((*m_arena)[childIndex].GetMove());
+  StorePosition(childIndex, environment);
+  uint32_t leafNode = Select(childIndex, environment);
+  float    result   = Expand(leafNode, environment, network);
+  ReturnToRoot(leafNode, environment);
+  Backpropagate(leafNode, result);
+}
+
+template<GameEnvironment Env>
+std::vector<float> MCTS<Env>::GetRootLogits() const
+{
+  std::vector<float> logits;
+  for (auto const & child: GetChildren(GetRoot()))
+  {
+    logits.emplace_back(std::log(std::max(child.GetPriorProbability(), 1e-8F)));
+  }
+  return logits;
+}
+
+template<GameEnvironment Env>
+std::vector<float> MCTS<Env>::GetCompletedQValues() const
+{
+  // unvisited children get the mixed value of the root instead of a Q-value
+  auto               children = GetChildren(GetRoot());
+  std::vector<float> priors;
+  std::vector<float> qValues;
+  std::vector<uint>  visitCounts;
+  for (auto const & child: children)
+  {
+    uint visitCount = child.GetVisitCount();
+    priors.emplace_back(child.GetPriorProbability());
+    qValues.emplace_back(visitCount > 0 ? child.GetValue() / (float)visitCount : 0.0F);
+    visitCounts.emplace_back(visitCount);
+  }
+  float mixedValue = GetMixedValue(priors, qValues, visitCounts, m_rootValue);
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    if (visitCounts[i] == 0)
+    {
+      qValues[i] = mixedValue;
+    }
+  }
+  return qValues;
+}
+
+template<GameEnvironment Env>
+uint MCTS<Env>::GetMaxVisitCount() const
+{
+  uint maxVisitCount = 0;
+  for (auto const & child: GetChildren(GetRoot()))
+  {
+    maxVisitCount = std::max(maxVisitCount, child.GetVisitCount());
+  }
+  return maxVisitCount;
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationsWorker(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, EvaluationQueue * evaluationQueue, bool showProgress)
+{
+  // the only environment this thread needs: moves are made while descending the tree and undone after every simulation
+  Env environment = *m_rootEnvironment;
+  if (evaluationQueue != nullptr)
+  {
+    RunSimulationsAsynchronous(simulations, numSimulations, *evaluationQueue, environment, showProgress);
+  }
+  else if (m_searchOptions.batchSize > 1)
+  {
+    RunSimulationsBatched(simulations, numSimulations, network, environment, showProgress);
+  }
+  else
+  {
+    RunSimulationsSequential(simulations, numSimulations, network, environment, showProgress);
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationsSequential(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, Env & environment, bool showProgress)
+{
+  std::optional<tqdm> bar;
+  if (showProgress)
+  {
+    bar.emplace();
+  }
+  uint simulation = 0;
+  while (!ShouldStop(simulations.load(), numSimulations) && (simulation = simulations.fetch_add(1)) < numSimulations)
+  {
+    if (bar)
+    {
+      bar->progress(simulation, numSimulations);
+    }
+    // 1. select, the virtual loss on the selected path makes other threads choose a different one
+    uint32_t leafNode = Select(m_root, environment);
+    AddVirtualLoss(leafNode);
+    // 2. expand and 3. evaluate
+    float result = Expand(leafNode, environment, network);
+    RemoveVirtualLoss(leafNode);
+    ReturnToRoot(leafNode, environment);
+    // 4. backpropagate
+    Backpropagate(leafNode, result);
+  }
+  if (bar)
+  {
+    bar->finish();
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationsBatched(std::atomic<uint> & simulations, uint numSimulations, NeuralNetworkInterface & network, Env & environment, bool showProgress)
+{
+  std::vector<uint32_t> batch;
+  std::vector<MoveList> validMoves; // the environment is back at the root when the batch is expanded
+  batch.reserve(m_searchOptions.batchSize);
+  validMoves.reserve(m_searchOptions.batchSize);
+
+  // the leaf positions are written straight into this buffer, which is reused for every batch
+  torch::Tensor inputs = torch::empty({(int64_t)m_searchOptions.batchSize, environment.GetInputPlanes(), environment.GetRows(), environment.GetColumns()});
+
+  std::optional<tqdm> bar;
+  if (showProgress)
+  {
+    bar.emplace();
+  }
+  while (!ShouldStop(simulations.load(), numSimulations) && simulations.load() < numSimulations)
+  {
+    if (bar)
+    {
+      bar->progress(std::min(simulations.load(), numSimulations), numSimulations);
+    }
+    batch.clear();
+    validMoves.clear();
+
+    // 1. select up to batchSize leaf nodes. Every selected path gets a virtual loss, so the next selection spreads out over the tree
+    while (batch.size() < m_searchOptions.batchSize && !ShouldStop(simulations.load(), numSimulations))
+    {
+      uint32_t leafNode = Select(m_root, environment);
+      if (auto knownValue = GetKnownValue(leafNode, environment))
+      {
+        ReturnToRoot(leafNode, environment);
+        if (simulations.fetch_add(1) >= numSimulations)
+        {
+          break;
+        }
+        // terminal and proven nodes don't need the network, backpropagate them right away
+        m_savedEvaluations.fetch_add(1, std::memory_order_relaxed);
+        Backpropagate(leafNode, *knownValue);
+        continue;
+      }
+      if (auto transpositionValue = EvaluateFromTranspositionTable(leafNode, environment))
+      {
+        ReturnToRoot(leafNode, environment);
+        if (simulations.fetch_add(1) >= numSimulations)
+        {
+          break;
+        }
+        // this position was already evaluated through another path in the tree
+        Backpropagate(leafNode, *transpositionValue);
+        continue;
+      }
+      if (std::find(batch.begin(), batch.end(), leafNode) != batch.end())
+      {
+        // the virtual loss wasn't enough to steer the selection away from a pending leaf: evaluate what we have
+        ReturnToRoot(leafNode, environment);
+        break;
+      }
+      if (simulations.fetch_add(1) >= numSimulations)
+      {
+        ReturnToRoot(leafNode, environment);
+        break;
+      }
+      AddVirtualLoss(leafNode);
+      environment.BoardToInput(inputs, (int64_t)batch.size());
+      validMoves.emplace_back(environment.GetValidMoves());
+      batch.emplace_back(leafNode);
+      ReturnToRoot(leafNode, environment);
+    }
+    if (batch.empty())
+    {
+      continue;
+    }
+
+    // 2. evaluate all leaf nodes with a single network call, moving the whole batch to the device at once
+    torch::Tensor input              = inputs.narrow(0, 0, (int64_t)batch.size()).to(Device::GetInstance().GetDevice());
+    auto [policyOutput, valueOutput] = network.Predict(input);
+
+    // 3. expand and 4. backpropagate every leaf node with its own row of the output
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+      RemoveVirtualLoss(batch[i]);
+      float value = valueOutput[(int64_t)i].item<float>();
+      StoreInTranspositionTable(batch[i], policyOutput[(int64_t)i], value);
+      CreateChildren(batch[i], validMoves[i], policyOutput[(int64_t)i]);
+      Backpropagate(batch[i], value);
+    }
+  }
+  if (bar)
+  {
+    bar->finish();
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RunSimulationsAsynchronous(std::atomic<uint> & simulations, uint numSimulations, EvaluationQueue & evaluationQueue, Env & environment, bool showProgress)
+{
+  struct PendingEvaluation
+  {
+    uint32_t                leafNode;
+    MoveList                validMoves; // the environment is back at the root when the evaluation completes
+    std::future<Evaluation> evaluation;
+  };
+  // the queue answers in the order of submission, so the oldest evaluation is always the first to complete
+  std::deque<PendingEvaluation> pending;
+
+  // when an evaluation throws, the exception leaves the search with other evaluations still pending.
+  // their virtual loss is removed on the way out, otherwise it would stay in the tree and steer every later search away from those paths
+  struct PendingGuard
+  {
+    MCTS &                          mcts;
+    std::deque<PendingEvaluation> & pending;
+
+    ~PendingGuard()
+    {
+      for (auto const & evaluation: pending)
+      {
+        mcts.RemoveVirtualLoss(evaluation.leafNode);
+      }
+    }
+  } pendingGuard{*this, pending};
+
+  auto completeOldest = [&](bool wait)
+  {
+    if (!wait && pending.front().evaluation.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      return false;
+    }
+    auto evaluation = evaluationQueue.Wait(pending.front().evaluation);
+    // the leaf is no longer pending once its evaluation is known, even if expanding it throws
+    PendingEvaluation completed = std::move(pending.front());
+    pending.pop_front();
+    RemoveVirtualLoss(completed.leafNode);
+    // 3. expand and 4. backpropagate
+    StoreInTranspositionTable(completed.leafNode, evaluation.policy, evaluation.value);
+    CreateChildren(completed.leafNode, completed.validMoves, evaluation.policy);
+    Backpropagate(completed.leafNode, evaluation.value);
+    return true;
+  };
+
+  std::optional<tqdm> bar;
+  if (showProgress)
+  {
+    bar.emplace();
+  }
+  while (true)
+  {
+    // backpropagate the evaluations that have completed, without waiting for the others
+    while (!pending.empty())
+    {
+      if (!completeOldest(false))
+      {
+        break;
+      }
+    }
+    bool stop = ShouldStop(simulations.load(), numSimulations) || simulations.load() >= numSimulations;
+    if (stop && pending.empty())
+    {
+      break;
+    }
+    if (bar)
+    {
+      bar->progress(std::min(simulations.load(), numSimulations), numSimulations);
+    }
+    if (stop || pending.size() >= m_searchOptions.batchSize)
+    {
+      // nothing left to select, or enough evaluations in flight: this is the only time the search waits for the network
+      completeOldest(true);
+      continue;
+    }
+
+    // 1. select, the virtual loss on the pending leaf nodes makes the next selections go elsewhere in the tree
+    uint32_t leafNode = Select(m_root, environment);
+    if (auto knownValue = GetKnownValue(leafNode, environment))
+    {
+      ReturnToRoot(leafNode, environment);
+      if (simulations.fetch_add(1) < numSimulations)
+      {
+        // terminal and proven nodes don't need the network, backpropagate them right away
+        m_savedEvaluations.fetch_add(1, std::memory_order_relaxed);
+        Backpropagate(leafNode, *knownValue);
+      }
+      continue;
+    }
+    if (auto transpositionValue = EvaluateFromTranspositionTable(leafNode, environment))
+    {
+      ReturnToRoot(leafNode, environment);
+      if (simulations.fetch_add(1) < numSimulations)
+      {
+        // this position was already evaluated through another path in the tree
+        Backpropagate(leafNode, *transpositionValue);
+      }
+      continue;
+    }
+    bool isPending = std::any_of(pending.begin(), pending.end(), [leafNode](auto const & evaluation) { return evaluation.leafNode == leafNode; });
+    if (isPending || simulations.fetch_add(1) >= numSimulations)
+    {
+      // the virtual loss wasn't enough to steer the selection away from a pending leaf: wait until it is expanded
+      ReturnToRoot(leafNode, environment);
+      if (isPending)
+      {
+        completeOldest(true);
+      }
+      continue;
+    }
+    // 2. send the leaf node to the network, and continue selecting while it is evaluated
+    pending.emplace_back(PendingEvaluation{leafNode, environment.GetValidMoves(), evaluationQueue.Submit(environment.BoardToInput())});
+    AddVirtualLoss(leafNode); // after the leaf is pending, so the guard removes it again
+    ReturnToRoot(leafNode, environment);
+  }
+  if (bar)
+  {
+    bar->finish();
+  }
+}
+
+template<GameEnvironment Env>
+SearchStatistics const & MCTS<Env>::GetStatistics() const
+{
+  return m_statistics;
+}
+
+template<GameEnvironment Env>
+uint MCTS<Env>::GetPeakNodes() const
+{
+  return m_statistics.peakNodeCount;
+}
+
+template<GameEnvironment Env>
+uint MCTS<Env>::GetSimulationsRun() const
+{
+  return m_statistics.simulations;
+}
+
+template<GameEnvironment Env>
+uint MCTS<Env>::GetSavedEvaluations() const
+{
+  return m_savedEvaluations.load(std::memory_order_relaxed);
+}
+
+template<GameEnvironment Env>
+Node const & MCTS<Env>::GetRoot() const
+{
+  return (*m_arena)[m_root];
+}
+
+template<GameEnvironment Env>
+Env const & MCTS<Env>::GetRootEnvironment() const
+{
+  return *m_rootEnvironment;
+}
+
+template<GameEnvironment Env>
+std::span<Node const> MCTS<Env>::GetChildren(Node const & node) const
+{
+  return std::as_const(*m_arena).GetRange(node.GetFirstChild(), node.GetChildCount());
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::EnableDirichletNoise(bool enable)
+{
+  m_dirichletNoiseOptions.enable = enable;
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::IsDirichletNoiseEnabled() const
+{
+  return m_dirichletNoiseOptions.enable;
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::ResetRoot(Env const & environment)
+{
+  // throw away the whole tree, the arena keeps its memory for the next search
+  m_rootEnvironment = std::make_unique<Env>(environment);
+  if (m_transpositionTable)
+  {
+    // the statistics in the table belong to the searches of the old tree
+    m_transpositionTable->Clear();
+  }
+  m_arena->Reset();
+  m_root         = m_arena->Allocate(1);
+  m_gumbelChoice = NO_NODE;
+  m_mergedRootVisits.clear();
+  (*m_arena)[m_root].Reset(NO_NODE, Move());
+  StorePosition(m_root, *m_rootEnvironment);
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::AdvanceRoot(Move move)
+{
+  // promote the child that was reached by the given move to the new root, keeping its subtree and statistics
+  Node const & root = GetRoot();
+  for (uint32_t i = 0; i < root.GetChildCount(); i++)
+  {
+    uint32_t     childIndex = root.GetFirstChild() + i;
+    Node const & child      = (*m_arena)[childIndex];
+    if (child.GetMove() == move)
+    {
+      // the new root needs its position, even if the search never reached it
+      m_rootEnvironment->MakeMove(move);
+      StorePosition(childIndex, *m_rootEnvironment);
+      // copy the subtree to the spare arena, the rest of the tree is freed by resetting the current arena
+      m_spareArena->Reset();
+      m_root         = CopySubtree(*m_arena, childIndex, *m_spareArena);
+      m_gumbelChoice = NO_NODE;
+      m_mergedRootVisits.clear();
+      std::swap(m_arena, m_spareArena);
+      m_spareArena->Reset();
+      return true;
+    }
+  }
+  return false;
+}
+
+template<GameEnvironment Env>
+uint32_t MCTS<Env>::CopySubtree(NodeArena const & source, uint32_t root, NodeArena & destination, uint32_t maxNodes)
+{
+  uint32_t newRoot = destination.Allocate(1);
+  destination[newRoot].CopyStatistics(source[root], NO_NODE);
+
+  // the most visited nodes are copied first, so when maxNodes is reached only the least visited subtrees are cut off
+  // all children of a node are copied at once, so they stay contiguous in the destination arena
+  std::priority_queue<std::tuple<uint, uint32_t, uint32_t>> queue; // visit count, source index, destination index
+  queue.emplace(source[root].GetVisitCount(), root, newRoot);
+  while (!queue.empty())
+  {
+    auto [visitCount, sourceIndex, destinationIndex] = queue.top();
+    queue.pop();
+    Node const & original = source[sourceIndex];
+    if (original.IsLeaf() || (uint64_t)destination.Size() + original.GetChildCount() > maxNodes)
+    {
+      // a node whose children don't fit becomes a leaf node with its statistics, the search expands it again when it reaches it
+      continue;
+    }
+    uint32_t firstChild = destination.Allocate(original.GetChildCount());
+    for (uint32_t c = 0; c < original.GetChildCount(); c++)
+    {
+      Node const & child = source[original.GetFirstChild() + c];
+      destination[firstChild + c].CopyStatistics(child, destinationIndex);
+      queue.emplace(child.GetVisitCount(), original.GetFirstChild() + c, firstChild + c);
+    }
+    destination[destinationIndex].FinishExpansion(firstChild, original.GetChildCount());
+  }
+  return newRoot;
+}
+
+template<GameEnvironment Env>
+uint32_t MCTS<Env>::Select(uint32_t root, Env & environment)
+{
+  // select nodes until we reach a leaf node (= a node that has not been expanded yet)
+  // do the selection using the Q+U formula, and make the move of every selected node so the environment follows the path
+  uint32_t current = root;
+  while (!(*m_arena)[current].IsLeaf())
+  {
+    if (m_searchOptions.useSolver && (*m_arena)[current].GetProvenValue())
+    {
+      // the result of a proven node is known, so its subtree doesn't have to be searched anymore
+      break;
+    }
+    Node const & node = (*m_arena)[current];
+    if (node.GetChildCount() == 0)
+    {
+      throw std::runtime_error("No best child found");
+    }
+    // the part of the exploration term that depends on the parent is the same for all children
+    float explorationFactor = GetExplorationFactor(node.GetVisitCount() + node.GetVirtualLoss());
+    // the statistics of the children are contiguous, so they are scored all at once
+    uint32_t firstChild = node.GetFirstChild();
+    current = firstChild + SelectBestChild(m_arena->GetStatistics(firstChild), NodeArena::GetOffset(firstChild), node.GetChildCount(), explorationFactor);
+    environment.MakeMove((*m_arena)[current].GetMove());
+    StorePosition(current, environment);
+  }
+  return current;
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::ReturnToRoot(uint32_t nodeIndex, Env & environment) const
+{
+  // undo one move for every node between the given node and the root
+  for (; nodeIndex != m_root; nodeIndex = (*m_arena)[nodeIndex].GetParent())
+  {
+    environment.UndoMove();
+  }
+}
+
+template<GameEnvironment Env>
+float MCTS<Env>::Expand(uint32_t nodeIndex, Env const & environment, NeuralNetworkInterface & network)
+{
+  // the value of a terminal or proven node is known, so it doesn't need to be evaluated by the network
+  if (auto knownValue = GetKnownValue(nodeIndex, environment))
+  {
+    m_savedEvaluations.fetch_add(1, std::memory_order_relaxed);
+    return *knownValue;
+  }
+  if (auto transpositionValue = EvaluateFromTranspositionTable(nodeIndex, environment))
+  {
+    // another path in the tree already reached this position, no need to evaluate it again
+    return *transpositionValue;
+  }
+
+  // create all possible child nodes
+  // 1. convert the node to an input usable by the neural network
+  torch::Tensor input = environment.BoardToInput();
+  // 2. run the neural network's predict function
+  auto [policyOutput, valueOutput] = network.Predict(input);
+
+  // 3. create a child node for each possible move in the policy output, and add them to the node
+  float value = valueOutput.view(1).item<float>();
+  StoreInTranspositionTable(nodeIndex, policyOutput[0], value);
+  CreateChildren(nodeIndex, environment.GetValidMoves(), policyOutput[0]);
+  // 4. return the value output
+  // = the value of the leaf node, assuming the current player has to make a move
+  return value;
+}
+
+template<GameEnvironment Env>
+std::optional<float> MCTS<Env>::GetKnownValue(uint32_t nodeIndex, Env const & environment)
+{
+  Node & node = (*m_arena)[nodeIndex];
+  if (auto provenValue = node.GetProvenValue())
+  {
+    return provenValue;
+  }
+  auto terminalValue = node.GetTerminalValue(environment);
+  if (terminalValue && m_searchOptions.useSolver)
+  {
+    // terminal nodes are the starting point of the proofs
+    node.SetProvenValue(*terminalValue);
+  }
+  return terminalValue;
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::TryProve(uint32_t nodeIndex)
+{
+  Node & node = (*m_arena)[nodeIndex];
+  if (node.GetProvenValue())
+  {
+    return true;
+  }
+  // the values of the children are from the perspective of the player to move in this node, who picks the best one
+  bool         allChildrenProven = true;
+  float        bestValue         = -INFINITY;
+  Node const * bestChild         = nullptr;
+  for (auto const & child: GetChildren(node))
+  {
+    auto childValue = child.GetProvenValue();
+    if (!childValue)
+    {
+      allChildrenProven = false;
+      continue;
+    }
+    if (*childValue > bestValue)
+    {
+      bestValue = *childValue;
+      bestChild = &child;
+    }
+    if (*childValue == 1.0F)
+    {
+      // one winning move is enough
+      break;
+    }
+  }
+  if (bestValue != 1.0F && !allChildrenProven)
+  {
+    return false;
+  }
+  // same sign convention as Backpropagate: flip the value if the player to move changed
+  // proven children were reached by the search, so their position is known
+  node.SetProvenValue(bestChild->GetCurrentPlayer() == node.GetCurrentPlayer() ? bestValue : -bestValue);
+  return true;
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::ShouldStop(uint simulations, uint numSimulations) const
+{
+  return IsSolved() || BestMoveIsDecided(simulations, numSimulations) || IsTreeFull();
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::IsTreeFull() const
+{
+  // the budget can be exceeded by the expansions that were already running when it was reached
+  return m_searchOptions.maxNodes > 0 && m_arena->Size() >= m_searchOptions.maxNodes;
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::PruneTreeIfFull(uint simulations, uint numSimulations)
+{
+  // only called when no thread is searching the tree, so nodes can be moved
+  m_statistics.peakNodeCount = std::max(m_statistics.peakNodeCount, m_arena->Size());
+  if (!IsTreeFull() || simulations >= numSimulations || IsSolved() || BestMoveIsDecided(simulations, numSimulations))
+  {
+    return false;
+  }
+  // keep the most visited half of the budget, so the search can run for a while before it has to prune again
+  uint32_t nodes = m_arena->Size();
+  m_spareArena->Reset();
+  m_root = CopySubtree(*m_arena, m_root, *m_spareArena, m_searchOptions.maxNodes / 2);
+  std::swap(m_arena, m_spareArena);
+  m_spareArena->Reset();
+  LDEBUG << "Pruned the tree from " << nodes << " to " << m_arena->Size() << " nodes after " << simulations << " simulations";
+  if (IsTreeFull())
+  {
+    throw std::runtime_error("Node budget of " + std::to_string(m_searchOptions.maxNodes) + " is too small to search this position");
+  }
+  return true;
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::BestMoveIsDecided(uint simulations, uint numSimulations) const
+{
+  if (!m_searchOptions.stopEarly || simulations < m_searchOptions.minSimulations || simulations >= numSimulations)
+  {
+    return false;
+  }
+  uint mostVisits       = 0;
+  uint secondMostVisits = 0;
+  for (auto const & child: GetChildren(GetRoot()))
+  {
+    uint visitCount = child.GetVisitCount();
+    if (visitCount > mostVisits)
+    {
+      secondMostVisits = mostVisits;
+      mostVisits       = visitCount;
+    }
+    else if (visitCount > secondMostVisits)
+    {
+      secondMostVisits = visitCount;
+    }
+  }
+  // the simulations that are still being evaluated haven't been added to the visit counts yet, so they count as remaining
+  uint remainingSimulations = numSimulations - simulations + GetRoot().GetVirtualLoss();
+  return mostVisits - secondMostVisits > remainingSimulations;
+}
+
+template<GameEnvironment Env>
+bool MCTS<Env>::IsSolved() const
+{
+  return m_searchOptions.useSolver && GetRoot().GetProvenValue().has_value();
+}
+
+template<GameEnvironment Env>
+std::optional<float> MCTS<Env>::EvaluateFromTranspositionTable(uint32_t nodeIndex, Env const & environment)
+{
+  if (!m_transpositionTable)
+  {
+    return std::nullopt;
+  }
+  auto entry = m_transpositionTable->Find((*m_arena)[nodeIndex].GetHash());
+  if (!entry)
+  {
+    return std::nullopt;
+  }
+  m_transpositionHits.fetch_add(1, std::memory_order_relaxed);
+  CreateChildren(nodeIndex, environment.GetValidMoves(), entry->policy);
+  // use the statistics of all nodes that reached this position, they are more accurate than a single evaluation
+  if (entry->visitCount > 0)
+  {
+    return entry->valueSum / (float)entry->visitCount;
+  }
+  return entry->value;
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::StoreInTranspositionTable(uint32_t nodeIndex, torch::Tensor const & policyOutput, float value)
+{
+  if (m_transpositionTable)
+  {
+    m_transpositionTable->Store((*m_arena)[nodeIndex].GetHash(), policyOutput, value);
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::CreateChildren(uint32_t nodeIndex, MoveList const & validMoves, torch::Tensor const & policyOutput)
+{
+  Node & node = (*m_arena)[nodeIndex];
+  if (!node.TryStartExpansion())
+  {
+    // another thread is already expanding this node
+    return;
+  }
+  m_expansions.fetch_add(1, std::memory_order_relaxed);
+
+  // reshape the policy output of this node to the shape of the board, which is the same for every node
+  torch::Tensor policy = policyOutput.view({m_rootEnvironment->GetRows(), m_rootEnvironment->GetColumns()});
+
+  // all children are allocated next to each other
+  uint32_t firstChild = m_arena->Allocate(validMoves.size());
+  for (size_t i = 0; i < validMoves.size(); i++)
+  {
+    Move move = validMoves[i];
+    // the child only stores its move and prior, its position is stored the first time the search descends into it
+    Node & child = (*m_arena)[firstChild + i];
+    child.Reset(nodeIndex, move);
+    child.SetPriorProbability(policy[move.GetRow()][move.GetColumn()].item<float>());
+  }
+  node.FinishExpansion(firstChild, validMoves.size());
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::StorePosition(uint32_t nodeIndex, Env const & environment)
+{
+  // the environment is at the position of the node, store what the search needs to know about it without the environment
+  Node & node = (*m_arena)[nodeIndex];
+  if (node.IsPositionKnown())
+  {
+    return;
+  }
+  node.SetPosition(environment.GetCurrentPlayer(), environment.GetHash());
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::AddVirtualLoss(uint32_t nodeIndex)
+{
+  // from the leaf node up to the root
+  for (; nodeIndex != NO_NODE; nodeIndex = (*m_arena)[nodeIndex].GetParent())
+  {
+    (*m_arena)[nodeIndex].AddVirtualLoss();
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::RemoveVirtualLoss(uint32_t nodeIndex)
+{
+  for (; nodeIndex != NO_NODE; nodeIndex = (*m_arena)[nodeIndex].GetParent())
+  {
+    (*m_arena)[nodeIndex].RemoveVirtualLoss();
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::Backpropagate(uint32_t nodeIndex, float reward)
+{
+  auto currentPlayer = (*m_arena)[nodeIndex].GetCurrentPlayer();
+  // starting from the given leaf node, go up the tree and update the visit counts and values
+  Node * currentNode = &(*m_arena)[nodeIndex];
+  uint   depth       = 0;
+  while (currentNode->GetParent() != NO_NODE)
+  {
+    depth++;
+    currentNode->IncrementVisitCount();
+    float value = currentNode->GetCurrentPlayer() == currentPlayer ? reward : -reward;
+    currentNode->AddValue(value);
+    if (m_transpositionTable)
+    {
+      // the value of a node only depends on its position, so it is shared with all other nodes of the same position
+      m_transpositionTable->AddValue(currentNode->GetHash(), value);
+    }
+    currentNode = &(*m_arena)[currentNode->GetParent()];
+  }
+  currentNode->IncrementVisitCount(); // root node
+
+  // the depth of the leaf is counted on the way up, so the tree never has to be traversed to measure it
+  m_leafCount.fetch_add(1, std::memory_order_relaxed);
+  m_leafDepthSum.fetch_add(depth, std::memory_order_relaxed);
+  uint maxDepth = m_maxLeafDepth.load(std::memory_order_relaxed);
+  while (depth > maxDepth && !m_maxLeafDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed))
+  {
+  }
+
+  if (m_searchOptions.useSolver)
+  {
+    // a proven node can only prove its ancestors, stop at the first ancestor that can't be proven yet
+    for (uint32_t index = nodeIndex; (*m_arena)[index].GetParent() != NO_NODE && (*m_arena)[index].GetProvenValue(); index = (*m_arena)[index].GetParent())
+    {
+      if (!TryProve((*m_arena)[index].GetParent()))
+      {
+        break;
+      }
+    }
+  }
+}
+
+template<GameEnvironment Env>
+void MCTS<Env>::AddDirichletNoiseToRoot()
+{
+  auto children = GetChildren(GetRoot());
+  if (children.empty())
+  {
+    LWARN << "No children found, cannot add dirichlet noise";
+  }
+
+  // get the prior probabilities
+  std::vector<float> priorProbabilities;
+  priorProbabilities.reserve(children.size());
+  for (auto const & child: children)
+  {
+    priorProbabilities.emplace_back(child.GetPriorProbability());
+  }
+
+  // add dirichlet noise to the prior probabilities of the root node
+  std::vector<float> dirichletNoise = RandomGenerator::CalculateDirichletNoise(priorProbabilities,
+                                                                               m_dirichletNoiseOptions.alpha,
+                                                                               m_dirichletNoiseOptions.beta,
+                                                                               m_dirichletNoiseOptions.dirichletFraction);
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    (*m_arena)[GetRoot().GetFirstChild() + i].SetPriorProbability(dirichletNoise[i]);
+  }
+}
+
+template<GameEnvironment Env>
+Move MCTS<Env>::GetBestMove(bool stochasticSearch) const
+{
+  // get the best move from the root node
+  // if stochasticSearch is true, use the visit counts as probabilities
+  // if stochasticSearch is false, use the highest visit count
+  if (m_searchOptions.useSolver)
+  {
+    // a proven win doesn't need many visits, so always play it when there is one
+    for (auto const & child: GetChildren(GetRoot()))
+    {
+      if (child.GetProvenValue() == 1.0F)
+      {
+        return child.GetMove();
+      }
+    }
+  }
+  if (m_searchOptions.useGumbel && m_gumbelChoice != NO_NODE)
+  {
+    if (stochasticSearch)
+    {
+      // the gumbel noise already made the choice stochastic, so the move that survived sequential halving is played
+      return GetChildren(GetRoot())[m_gumbelChoice].GetMove();
+    }
+    // without the noise, the best move is the one with the highest improved policy
+    auto policy = GetPolicyTarget();
+    return GetChildren(GetRoot())[std::max_element(policy.begin(), policy.end()) - policy.begin()].GetMove();
+  }
+  return stochasticSearch ? GetBestMoveStochastic() : GetBestMoveDeterministic();
+}
+
+template<GameEnvironment Env>
+std::vector<float> MCTS<Env>::GetPolicyTarget() const
+{
+  if (m_searchOptions.useGumbel)
+  {
+    // the improved policy of the completed Q-values, which also has a target for the moves that weren't visited
+    return GetImprovedPolicy(GetRootLogits(), GetCompletedQValues(), GetMaxVisitCount());
+  }
+  return GetVisitPolicy();
+}
+
+template<GameEnvironment Env>
+std::vector<float> MCTS<Env>::GetVisitPolicy() const
+{
+  // the visit counts of the root children, normalized
+  auto               visitCounts = GetRootVisitCounts();
+  std::vector<float> policy;
+  policy.reserve(visitCounts.size());
+  uint totalVisitCount = std::accumulate(visitCounts.begin(), visitCounts.end(), 0U);
+  if (totalVisitCount > 0)
+  {
+    for (auto visitCount: visitCounts)
+    {
+      policy.emplace_back((float)visitCount / (float)totalVisitCount);
+    }
+    return policy;
+  }
+  // none of the children were visited, for example when no simulations ran: use the priors, or a uniform policy if they are all zero
+  auto  children = GetChildren(GetRoot());
+  float priorSum = 0.0F;
+  for (auto const & child: children)
+  {
+    priorSum += child.GetPriorProbability();
+  }
+  for (auto const & child: children)
+  {
+    policy.emplace_back(priorSum > 0.0F ? child.GetPriorProbability() / priorSum : 1.0F / (float)children.size());
+  }
+  return policy;
+}
+
+template<GameEnvironment Env>
+std::vector<uint> MCTS<Env>::GetRootVisitCounts() const
+{
+  if (!m_mergedRootVisits.empty())
+  {
+    return m_mergedRootVisits;
+  }
+  std::vector<uint> visitCounts;
+  for (auto const & child: GetChildren(GetRoot()))
+  {
+    visitCounts.emplace_back(child.GetVisitCount());
+  }
+  return visitCounts;
+}
+
+template<GameEnvironment Env>
+Move MCTS<Env>::GetBestMoveStochastic() const
+{
+  auto children = GetChildren(GetRoot());
+  if (children.empty())
+  {
+    throw std::runtime_error("No children found while getting best move");
+  }
+  // sample from the normalized visit counts
+  uint stochasticIndex = RandomGenerator::StochasticSample(GetVisitPolicy());
+  return children[stochasticIndex].GetMove();
+}
+
+template<GameEnvironment Env>
+Move MCTS<Env>::GetBestMoveDeterministic() const
+{
+  auto children = GetChildren(GetRoot());
+  if (children.empty())
+  {
+    throw std::runtime_error("No children found while getting best move");
+  }
+  // find the child with the highest visit count, or the highest prior if no child was visited
+  auto policy    = GetVisitPolicy();
+  auto bestChild = std::max_element(policy.begin(), policy.end());
+  if (bestChild == policy.end())
+  {
+    throw std::runtime_error("No best child found");
+  }
+  return children[bestChild - policy.begin()].GetMove();
+}
\ No newline at end of file
@@ -1,106 +1,209 @@
 #include "Node.hpp"
 
-#include <cmath>
+#include "Puct.hpp"
 
-namespace
+static_assert(std::atomic_ref<float>::is_always_lock_free, "Node statistics need lock-free float atomics");
+
+void Node::Bind(NodeStatistics * statistics, uint32_t offset)
 {
-auto constexpr PB_C_BASE = 19652.0F;
-auto constexpr PB_C_INIT = 1.25F;
-auto constexpr C_PUCT    = 1.25F; // PUCT constant: higher -> more exploration, lower -> more exploitation
-} // namespace
+  // called once by the arena when the block of this node is allocated
+  m_statistics = statistics;
+  m_offset     = offset;
+}
 
-Node::Node(std::shared_ptr<Environment> environment, std::shared_ptr<Node> parent, std::shared_ptr<Move> move)
-  : m_environment(std::move(environment))
-  , m_parent(std::move(parent))
-  , m_move(std::move(move))
+void Node::Reset(uint32_t parent, Move move)
 {
+  // nodes are reused by the arena, so every member has to be reinitialized here
+  m_move       = move;
+  m_parent     = parent;
+  m_firstChild = NO_NODE;
+  m_childCount = 0;
+  m_expansionState.store(ExpansionState::UNEXPANDED, std::memory_order_relaxed);
+  m_positionKnown.store(false, std::memory_order_relaxed);
+  m_currentPlayer.store(Player::PLAYER_NONE, std::memory_order_relaxed);
+  m_hash.store(0, std::memory_order_relaxed);
+  m_terminalState.store(TerminalState::UNKNOWN, std::memory_order_relaxed);
+  m_provenResult.store(ProvenResult::UNPROVEN, std::memory_order_relaxed);
+  GetStatistic(m_statistics->priorProbabilities).store(0.0F, std::memory_order_relaxed);
+  GetStatistic(m_statistics->visitCounts).store(0.0F, std::memory_order_relaxed);
+  GetStatistic(m_statistics->values).store(0.0F, std::memory_order_relaxed);
+  GetStatistic(m_statistics->virtualLosses).store(0.0F, std::memory_order_relaxed);
+}
+
+void Node::CopyStatistics(Node const & other, uint32_t parent)
+{
+  // copies everything except the children, which have to be copied to their new indices by the caller
+  Reset(parent, other.GetMove());
+  if (other.IsPositionKnown())
+  {
+    SetPosition(other.GetCurrentPlayer(), other.GetHash());
+  }
+  m_provenResult.store(other.m_provenResult.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  SetPriorProbability(other.GetPriorProbability());
+  SetVisitCount(other.GetVisitCount());
+  SetValue(other.GetValue());
 }
 
-Node::Node(std::shared_ptr<Environment> environment)
-  : m_environment(std::move(environment))
-  , m_move(nullptr)
+bool Node::IsPositionKnown() const
 {
-  // constructor for root node
+  return m_positionKnown.load(std::memory_order_acquire);
 }
 
-std::shared_ptr<Environment> const & Node::GetEnvironment() const
+void Node::SetPosition(Player currentPlayer, uint64_t hash)
 {
-  return m_environment;
+  // multiple threads can reach the node at the same time, they all store the same values
+  m_currentPlayer.store(currentPlayer, std::memory_order_relaxed);
+  m_hash.store(hash, std::memory_order_relaxed);
+  m_positionKnown.store(true, std::memory_order_release);
 }
 
-std::shared_ptr<Node> const & Node::GetParent() const
+Player Node::GetCurrentPlayer() const
+{
+  return m_currentPlayer.load(std::memory_order_relaxed);
+}
+
+uint32_t Node::GetParent() const
 {
   return m_parent;
 }
 
-std::shared_ptr<Move> Node::GetMove() const
+Move Node::GetMove() const
 {
   return m_move;
 }
 
+std::optional<float> Node::GetProvenValue() const
+{
+  switch (m_provenResult.load(std::memory_order_acquire))
+  {
+  case ProvenResult::WIN:
+    return 1.0F;
+  case ProvenResult::DRAW:
+    return 0.0F;
+  case ProvenResult::LOSS:
+    return -1.0F;
+  default:
+    return std::nullopt;
+  }
+}
+
+void Node::SetProvenValue(float value)
+{
+  auto result = value > 0.0F ? ProvenResult::WIN : (value < 0.0F ? ProvenResult::LOSS : ProvenResult::DRAW);
+  m_provenResult.store(result, std::memory_order_release);
+}
+
+uint64_t Node::GetHash() const
+{
+  return m_hash.load(std::memory_order_relaxed);
+}
+
 bool Node::IsLeaf() const
 {
-  return m_children.empty();
+  return m_expansionState.load(std::memory_order_acquire) != ExpansionState::EXPANDED;
+}
+
+uint32_t Node::GetFirstChild() const
+{
+  return m_firstChild;
 }
 
-std::vector<std::shared_ptr<Node>> const & Node::GetChildren() const
+uint32_t Node::GetChildCount() const
 {
-  return m_children;
+  return m_childCount;
 }
 
-void Node::AddChild(std::shared_ptr<Node> child)
+bool Node::TryStartExpansion()
 {
-  m_children.emplace_back(std::move(child));
+  // multiple threads can try to expand the same leaf node at the same time, only the first one gets to add its children
+  auto expected = ExpansionState::UNEXPANDED;
+  return m_expansionState.compare_exchange_strong(expected, ExpansionState::EXPANDING, std::memory_order_acq_rel);
+}
+
+void Node::FinishExpansion(uint32_t firstChild, uint32_t childCount)
+{
+  m_firstChild = firstChild;
+  m_childCount = childCount;
+  // publish the children to the other threads
+  m_expansionState.store(ExpansionState::EXPANDED, std::memory_order_release);
 }
 
 uint Node::GetVisitCount() const
 {
-  return m_visitCount;
+  return (uint)GetStatistic(m_statistics->visitCounts).load(std::memory_order_relaxed);
 }
 
 void Node::SetVisitCount(uint visitCount)
 {
-  m_visitCount = visitCount;
+  GetStatistic(m_statistics->visitCounts).store((float)visitCount, std::memory_order_relaxed);
 }
 
 void Node::IncrementVisitCount()
 {
-  m_visitCount++;
+  GetStatistic(m_statistics->visitCounts).fetch_add(1.0F, std::memory_order_relaxed);
+}
+
+uint Node::GetVirtualLoss() const
+{
+  return (uint)GetStatistic(m_statistics->virtualLosses).load(std::memory_order_relaxed);
+}
+
+void Node::AddVirtualLoss()
+{
+  GetStatistic(m_statistics->virtualLosses).fetch_add(1.0F, std::memory_order_relaxed);
+}
+
+void Node::RemoveVirtualLoss()
+{
+  if (GetStatistic(m_statistics->virtualLosses).fetch_sub(1.0F, std::memory_order_relaxed) <= 0.0F)
+  {
+    throw std::runtime_error("Cannot remove virtual loss from a node without virtual loss");
+  }
 }
 
 float Node::GetPriorProbability() const
 {
-  return m_move->GetPriorProbability();
+  return GetStatistic(m_statistics->priorProbabilities).load(std::memory_order_relaxed);
 }
 
 void Node::SetPriorProbability(float priorProbability)
 {
-  m_move->SetPriorProbability(priorProbability);
+  GetStatistic(m_statistics->priorProbabilities).store(priorProbability, std::memory_order_relaxed);
 }
 
 float Node::GetQValue() const
 {
-  return m_value / ((float)GetVisitCount() + 1e-3);
+  // every pending evaluation counts as a lost visit, so other selections avoid this path
+  auto virtualLoss = (float)GetVirtualLoss();
+  return (GetValue() - virtualLoss) / ((float)GetVisitCount() + virtualLoss + 1e-3F);
 }
 
-float Node::GetUValue() const
+float Node::GetUValue(Node const & parent) const
 {
-  if (m_parent == nullptr)
-  {
-    throw std::runtime_error("Parent is null. This shouldn't happen unless you call this function on the root node.");
-  }
-  // uses the PUCT formula based on AlphaZero's paper and pseudocode
-  float expRate = std::log((m_parent->GetVisitCount() + PB_C_BASE + 1.0F) / PB_C_BASE) + PB_C_INIT;
-  expRate *= std::sqrt((float)m_parent->GetVisitCount()) / ((float)GetVisitCount() + 1.0F);
-  return C_PUCT * expRate * GetPriorProbability();
+  return GetUValue(GetExplorationFactor(parent.GetVisitCount() + parent.GetVirtualLoss()));
+}
+
+float Node::GetUValue(float explorationFactor) const
+{
+  return explorationFactor * GetPriorProbability() / ((float)(GetVisitCount() + GetVirtualLoss()) + 1.0F);
 }
 
 float Node::GetValue() const
 {
-  return m_value;
+  return GetStatistic(m_statistics->values).load(std::memory_order_relaxed);
 }
 
 void Node::SetValue(float value)
 {
-  m_value = value;
+  GetStatistic(m_statistics->values).store(value, std::memory_order_relaxed);
+}
+
+void Node::AddValue(float value)
+{
+  GetStatistic(m_statistics->values).fetch_add(value, std::memory_order_relaxed);
+}
+
+std::atomic_ref<float> Node::GetStatistic(std::array<float, NodeStatistics::SIZE> & statistic) const
+{
+  return std::atomic_ref<float>(statistic[m_offset]);
 }
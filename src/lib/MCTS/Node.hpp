@@ -1,45 +1,115 @@
 #pragma once
 
-#include <memory>
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
 
-#include "../Environment/Environment.hpp"
+#include "../Environment/GameEnvironment.hpp"
+#include "NodeStatistics.hpp"
 
+uint32_t constexpr NO_NODE = std::numeric_limits<uint32_t>::max(); // index used when a node has no parent or no children
+
+/**
+ * @brief A node of the search tree. Nodes live in a NodeArena and refer to their parent and children by index.
+ * The children of a node are allocated next to each other, so they are stored as the index of the first child and a count.
+ * Nodes don't hold an environment: the search makes the moves of the nodes on its path on a single environment per thread,
+ * and undoes them again after the simulation. The position information a node needs is stored the first time it is reached.
+ * The search statistics of a node are not stored in the node itself, but in the NodeStatistics of its block in the arena.
+ */
 class Node
 {
 private:
-  std::vector<std::shared_ptr<Node>> m_children;          // children of this node
-  std::shared_ptr<Environment>       m_environment;       // environment at this node
-  std::shared_ptr<Node>              m_parent;            // parent of this node (nullptr if root)
-  std::shared_ptr<Move>              m_move;              // move that led to this node
-  uint                               m_visitCount = 0;    // number of times this node has been visited // TODO: should this be 1 at construction?
-  float                              m_value      = 0.0F; // value of this node
+  enum class ExpansionState : uint8_t
+  {
+    UNEXPANDED,
+    EXPANDING,
+    EXPANDED
+  };
+
+  enum class TerminalState : uint8_t
+  {
+    UNKNOWN,
+    NON_TERMINAL,
+    TERMINAL
+  };
+
+  // result of the node with perfect play, from the perspective of the player that made the move to this node
+  enum class ProvenResult : uint8_t
+  {
+    UNPROVEN,
+    WIN,
+    DRAW,
+    LOSS
+  };
+
+  Move                               m_move;                                          // move that led to this node, its prior is stored in the statistics
+  uint32_t                           m_parent           = NO_NODE;                    // index of the parent of this node (NO_NODE if root)
+  uint32_t                           m_firstChild       = NO_NODE;                    // index of the first child, the other children directly follow it
+  uint32_t                           m_childCount       = 0;                          // amount of children of this node
+  std::atomic<ExpansionState>        m_expansionState   = ExpansionState::UNEXPANDED; // the children are never modified once EXPANDED
+  std::atomic<bool>                  m_positionKnown    = false;                      // set once the current player and hash have been stored
+  std::atomic<Player>                m_currentPlayer    = Player::PLAYER_NONE;        // player to move in the position of this node
+  mutable std::atomic<TerminalState> m_terminalState    = TerminalState::UNKNOWN;     // determined the first time the node is reached
+  mutable std::atomic<float>         m_terminalValue    = 0.0F;                       // value of the node if it is terminal
+  std::atomic<ProvenResult>          m_provenResult     = ProvenResult::UNPROVEN;     // only used when the solver is enabled
+  NodeStatistics *                   m_statistics       = nullptr;                    // statistics of the block this node is stored in
+  uint32_t                           m_offset           = 0;                          // offset of this node in the statistics of its block
+  std::atomic<uint64_t>              m_hash             = 0;                          // zobrist hash of the position
 
 public:
-  Node(std::shared_ptr<Environment> environment, std::shared_ptr<Node> parent, std::shared_ptr<Move> move);
-  Node(std::shared_ptr<Environment> environment);
+  Node()  = default;
   ~Node() = default;
 
-  std::shared_ptr<Environment> const & GetEnvironment() const;
+  Node(Node const &)             = delete;
+  Node & operator=(Node const &) = delete;
+
+  void Bind(NodeStatistics * statistics, uint32_t offset);
+  void Reset(uint32_t parent, Move move);
+  void CopyStatistics(Node const & other, uint32_t parent);
+
+  bool   IsPositionKnown() const;
+  void   SetPosition(Player currentPlayer, uint64_t hash);
+  Player GetCurrentPlayer() const;
 
-  std::shared_ptr<Node> const & GetParent() const;
+  uint32_t GetParent() const;
 
-  std::shared_ptr<Move> GetMove() const;
+  Move GetMove() const;
+
+  uint64_t GetHash() const;
 
   float GetPriorProbability() const;
   void  SetPriorProbability(float priorProbability);
 
-  bool                                       IsLeaf() const;
-  std::vector<std::shared_ptr<Node>> const & GetChildren() const;
-  void                                       AddChild(std::shared_ptr<Node> child);
+  template<GameEnvironment Env>
+  std::optional<float> GetTerminalValue(Env const & environment) const;
+  std::optional<float> GetProvenValue() const;
+  void                 SetProvenValue(float value);
+
+  bool     IsLeaf() const;
+  uint32_t GetFirstChild() const;
+  uint32_t GetChildCount() const;
+  bool     TryStartExpansion();
+  void     FinishExpansion(uint32_t firstChild, uint32_t childCount);
 
   uint GetVisitCount() const;
   void SetVisitCount(uint visitCount);
   void IncrementVisitCount();
 
+  uint GetVirtualLoss() const;
+  void AddVirtualLoss();
+  void RemoveVirtualLoss();
+
   float GetQValue() const;
-  float GetUValue() const;
+  float GetUValue(Node const & parent) const;
+  float GetUValue(float explorationFactor) const;
 
   float GetValue() const;
   void  SetValue(float value);
-};
\ No newline at end of file
+  void  AddValue(float value);
+
+private:
+  std::atomic_ref<float> GetStatistic(std::array<float, NodeStatistics::SIZE> & statistic) const;
+};
+
+#include "Node.ipp"
@@ -0,0 +1,32 @@
+#include "Node.hpp"
+
+template<GameEnvironment Env>
+std::optional<float> Node::GetTerminalValue(Env const & environment) const
+{
+  auto state = m_terminalState.load(std::memory_order_acquire);
+  if (state == TerminalState::UNKNOWN)
+  {
+    // the position of a node never changes, so this only has to be checked once
+    // if multiple threads check it at the same time, they all come to the same result
+    float value  = 0.0F;
+    auto  winner = environment.GetWinner();
+    if (winner == Player::PLAYER_NONE)
+    {
+      state = environment.IsTerminal() ? TerminalState::TERMINAL : TerminalState::NON_TERMINAL; // a terminal board without winner is a draw
+    }
+    else
+    {
+      state = TerminalState::TERMINAL;
+      // if the winner of the this leaf node's board is the current player
+      // then the opponent made the move that led to this winning board
+      value = winner == environment.GetCurrentPlayer() ? -1.0F : 1.0F;
+    }
+    m_terminalValue.store(value, std::memory_order_relaxed);
+    m_terminalState.store(state, std::memory_order_release);
+  }
+  if (state == TerminalState::NON_TERMINAL)
+  {
+    return std::nullopt;
+  }
+  return m_terminalValue.load(std::memory_order_relaxed);
+}
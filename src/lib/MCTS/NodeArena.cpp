@@ -0,0 +1,102 @@
+#include "NodeArena.hpp"
+
+#include <stdexcept>
+
+NodeArena::NodeArena()
+  : m_blocks(std::make_unique<Block[]>(MAX_BLOCKS))
+{
+}
+
+uint32_t NodeArena::Allocate(uint32_t count)
+{
+  if (count == 0 || count > BLOCK_SIZE)
+  {
+    throw std::runtime_error("Cannot allocate " + std::to_string(count) + " nodes at once");
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  uint32_t                    first = m_size.load(std::memory_order_relaxed);
+  // the nodes have to be contiguous, so they can't be spread over two blocks
+  if ((first & (BLOCK_SIZE - 1)) + count > BLOCK_SIZE)
+  {
+    first = ((first >> BLOCK_SHIFT) + 1) << BLOCK_SHIFT;
+  }
+  uint32_t lastBlock = (first + count - 1) >> BLOCK_SHIFT;
+  if (lastBlock >= MAX_BLOCKS)
+  {
+    throw std::runtime_error("Node arena is full");
+  }
+  // blocks are only allocated the first time they are needed, after that they are reused
+  while (m_allocatedBlocks <= lastBlock)
+  {
+    Block & block    = m_blocks[m_allocatedBlocks++];
+    block.nodes      = std::make_unique<Node[]>(BLOCK_SIZE);
+    block.statistics = std::make_unique<NodeStatistics>();
+    for (uint32_t i = 0; i < BLOCK_SIZE; i++)
+    {
+      block.nodes[i].Bind(block.statistics.get(), i);
+    }
+  }
+  m_size.store(first + count, std::memory_order_relaxed);
+  return first;
+}
+
+void NodeArena::Reset()
+{
+  // nodes are reinitialized when they are allocated again, so resetting the arena doesn't have to touch them
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_size.store(0, std::memory_order_relaxed);
+}
+
+uint32_t NodeArena::Size() const
+{
+  return m_size.load(std::memory_order_relaxed);
+}
+
+size_t NodeArena::Capacity() const
+{
+  return (size_t)m_allocatedBlocks * BLOCK_SIZE;
+}
+
+size_t NodeArena::GetMemoryUsage() const
+{
+  return Capacity() * sizeof(Node) + (size_t)m_allocatedBlocks * sizeof(NodeStatistics);
+}
+
+Node & NodeArena::operator[](uint32_t index)
+{
+  return m_blocks[index >> BLOCK_SHIFT].nodes[GetOffset(index)];
+}
+
+Node const & NodeArena::operator[](uint32_t index) const
+{
+  return m_blocks[index >> BLOCK_SHIFT].nodes[GetOffset(index)];
+}
+
+std::span<Node> NodeArena::GetRange(uint32_t first, uint32_t count)
+{
+  if (count == 0)
+  {
+    return {};
+  }
+  return {&(*this)[first], count};
+}
+
+std::span<Node const> NodeArena::GetRange(uint32_t first, uint32_t count) const
+{
+  if (count == 0)
+  {
+    return {};
+  }
+  return {&(*this)[first], count};
+}
+
+NodeStatistics const & NodeArena::GetStatistics(uint32_t index) const
+{
+  return *m_blocks[index >> BLOCK_SHIFT].statistics;
+}
+
+uint32_t NodeArena::GetOffset(uint32_t index)
+{
+  return index & (BLOCK_SIZE - 1);
+}
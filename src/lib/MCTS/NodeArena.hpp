@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "Node.hpp"
+
+/**
+ * @brief Contiguous storage for the nodes of a search tree.
+ * Nodes are stored in fixed-size blocks which are kept when the arena is reset, so once the blocks are allocated,
+ * expanding a node doesn't allocate any memory for it. Nodes refer to each other by their 32-bit index in the arena.
+ * Next to the nodes, every block holds the NodeStatistics of its nodes.
+ */
+class NodeArena
+{
+public:
+  static uint32_t constexpr BLOCK_SHIFT = 12;
+  static uint32_t constexpr BLOCK_SIZE  = 1U << BLOCK_SHIFT; // amount of nodes per block
+  static uint32_t constexpr MAX_BLOCKS  = 1U << 14;          // the arena can hold 64M nodes
+
+  static_assert(BLOCK_SIZE == NodeStatistics::SIZE, "A block of nodes has to match the size of its statistics");
+
+private:
+  struct Block
+  {
+    std::unique_ptr<Node[]>         nodes;
+    std::unique_ptr<NodeStatistics> statistics;
+  };
+
+  std::unique_ptr<Block[]> m_blocks;              // blocks are never moved, so references to nodes stay valid
+  uint32_t                 m_allocatedBlocks = 0; // amount of blocks that have been allocated
+  std::atomic<uint32_t>    m_size            = 0; // index of the next free node
+  std::mutex               m_mutex;               // guards the allocation of new nodes
+
+public:
+  NodeArena();
+  ~NodeArena() = default;
+
+  NodeArena(NodeArena const &)             = delete;
+  NodeArena & operator=(NodeArena const &) = delete;
+
+  uint32_t Allocate(uint32_t count);
+  void     Reset();
+
+  uint32_t Size() const;
+  size_t   Capacity() const;
+  size_t   GetMemoryUsage() const; // bytes of the allocated blocks, including their statistics
+
+  Node &       operator[](uint32_t index);
+  Node const & operator[](uint32_t index) const;
+
+  std::span<Node>       GetRange(uint32_t first, uint32_t count);
+  std::span<Node const> GetRange(uint32_t first, uint32_t count) const;
+
+  // the statistics of the block that contains the node at the given index, and the offset of the node in it
+  NodeStatistics const & GetStatistics(uint32_t index) const;
+  static uint32_t        GetOffset(uint32_t index);
+};
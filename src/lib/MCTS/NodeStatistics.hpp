@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Search statistics of a block of nodes, stored as a structure of arrays.
+ * Siblings are allocated next to each other, so the statistics of all children of a node form contiguous ranges in these arrays,
+ * which lets the selection step score all children at once with SIMD instructions.
+ * The values are updated through std::atomic_ref, so multiple threads can search the same tree.
+ */
+struct NodeStatistics
+{
+  static uint32_t constexpr SIZE = 1U << 12; // amount of nodes per block
+
+  alignas(32) std::array<float, SIZE> priorProbabilities; // prior probability of the move that led to each node
+  alignas(32) std::array<float, SIZE> visitCounts;        // visit counts, stored as floats so they don't have to be converted during selection
+  alignas(32) std::array<float, SIZE> values;             // sum of the values of all simulations through each node
+  alignas(32) std::array<float, SIZE> virtualLosses;      // amount of pending evaluations that passed through each node
+};
@@ -0,0 +1,165 @@
+#include "Puct.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PUCT_HAS_X86 1
+#endif
+
+namespace
+{
+auto constexpr PB_C_BASE = 19652.0F;
+auto constexpr PB_C_INIT = 1.25F;
+auto constexpr C_PUCT    = 1.25F; // PUCT constant: higher -> more exploration, lower -> more exploitation
+
+uint32_t constexpr EXPLORATION_TABLE_SIZE = 1U << 16; // visit counts below this don't need a log and sqrt during selection
+
+// the other search threads update the statistics through std::atomic_ref while they are read here, so they are loaded the same way
+float LoadStatistic(float const & statistic)
+{
+  // std::atomic_ref can't refer to a const object before C++26, the load doesn't modify it
+  return std::atomic_ref<float>(const_cast<float &>(statistic)).load(std::memory_order_relaxed);
+}
+
+#ifdef PUCT_HAS_X86
+// compiled for AVX2 on its own, the rest of the project doesn't need to be built with -mavx2
+__attribute__((target("avx2"))) uint32_t SelectBestChildAvx2(NodeStatistics const & statistics, uint32_t first, uint32_t count, float explorationFactor)
+{
+  float const * priorProbabilities = statistics.priorProbabilities.data() + first;
+  float const * visitCounts        = statistics.visitCounts.data() + first;
+  float const * values             = statistics.values.data() + first;
+  float const * virtualLosses      = statistics.virtualLosses.data() + first;
+
+  __m256 const  factor  = _mm256_set1_ps(explorationFactor);
+  __m256 const  one     = _mm256_set1_ps(1.0F);
+  __m256 const  epsilon = _mm256_set1_ps(1e-3F);
+  __m256i const step    = _mm256_set1_epi32(8);
+
+  // every lane keeps track of its own best score, they are merged after the loop
+  __m256  bestScores  = _mm256_set1_ps(-INFINITY);
+  __m256i bestIndices = _mm256_setzero_si256();
+  __m256i indices     = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  // every block of 8 children is first copied with atomic loads, the vector loads then read the copy instead of the shared statistics
+  alignas(32) float blockPriors[8];
+  alignas(32) float blockVisitCounts[8];
+  alignas(32) float blockValues[8];
+  alignas(32) float blockVirtualLosses[8];
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    for (uint32_t lane = 0; lane < 8; lane++)
+    {
+      blockPriors[lane]        = LoadStatistic(priorProbabilities[i + lane]);
+      blockVisitCounts[lane]   = LoadStatistic(visitCounts[i + lane]);
+      blockValues[lane]        = LoadStatistic(values[i + lane]);
+      blockVirtualLosses[lane] = LoadStatistic(virtualLosses[i + lane]);
+    }
+    __m256 visitCount  = _mm256_load_ps(blockVisitCounts);
+    __m256 virtualLoss = _mm256_load_ps(blockVirtualLosses);
+    __m256 visits      = _mm256_add_ps(visitCount, virtualLoss);
+    // Q = (W - virtual loss) / (N + virtual loss)
+    __m256 q = _mm256_div_ps(_mm256_sub_ps(_mm256_load_ps(blockValues), virtualLoss), _mm256_add_ps(visits, epsilon));
+    // U = exploration factor * P / (N + virtual loss + 1)
+    __m256 u     = _mm256_div_ps(_mm256_mul_ps(factor, _mm256_load_ps(blockPriors)), _mm256_add_ps(visits, one));
+    __m256 score = _mm256_add_ps(q, u);
+
+    __m256 better = _mm256_cmp_ps(score, bestScores, _CMP_GT_OQ);
+    bestScores    = _mm256_blendv_ps(bestScores, score, better);
+    bestIndices   = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndices), _mm256_castsi256_ps(indices), better));
+    indices       = _mm256_add_epi32(indices, step);
+  }
+
+  alignas(32) float   laneScores[8];
+  alignas(32) int32_t laneIndices[8];
+  _mm256_store_ps(laneScores, bestScores);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(laneIndices), bestIndices);
+
+  float    bestScore = -INFINITY;
+  uint32_t bestChild = 0;
+  for (uint32_t lane = 0; lane < 8; lane++)
+  {
+    // on a tie, prefer the lowest index, just like the scalar version
+    if (laneScores[lane] > bestScore || (laneScores[lane] == bestScore && (uint32_t)laneIndices[lane] < bestChild))
+    {
+      bestScore = laneScores[lane];
+      bestChild = laneIndices[lane];
+    }
+  }
+  // the remaining children that didn't fill a whole vector
+  for (; i < count; i++)
+  {
+    float virtualLoss = LoadStatistic(virtualLosses[i]);
+    float visits      = LoadStatistic(visitCounts[i]) + virtualLoss;
+    float score       = (LoadStatistic(values[i]) - virtualLoss) / (visits + 1e-3F) + explorationFactor * LoadStatistic(priorProbabilities[i]) / (visits + 1.0F);
+    if (score > bestScore)
+    {
+      bestScore = score;
+      bestChild = i;
+    }
+  }
+  return bestChild;
+}
+#endif
+} // namespace
+
+float GetExplorationFactor(float parentVisitCount)
+{
+  // uses the PUCT formula based on AlphaZero's paper and pseudocode
+  float expRate = std::log((parentVisitCount + PB_C_BASE + 1.0F) / PB_C_BASE) + PB_C_INIT;
+  return C_PUCT * expRate * std::sqrt(parentVisitCount);
+}
+
+float GetExplorationFactor(uint32_t parentVisitCount)
+{
+  static auto const table = []()
+  {
+    auto factors = std::make_unique<std::array<float, EXPLORATION_TABLE_SIZE>>();
+    for (uint32_t i = 0; i < EXPLORATION_TABLE_SIZE; i++)
+    {
+      (*factors)[i] = GetExplorationFactor((float)i);
+    }
+    return factors;
+  }();
+  if (parentVisitCount < EXPLORATION_TABLE_SIZE)
+  {
+    return (*table)[parentVisitCount];
+  }
+  return GetExplorationFactor((float)parentVisitCount);
+}
+
+uint32_t SelectBestChild(NodeStatistics const & statistics, uint32_t first, uint32_t count, float explorationFactor)
+{
+#ifdef PUCT_HAS_X86
+  static bool const hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+  if (hasAvx2)
+  {
+    return SelectBestChildAvx2(statistics, first, count, explorationFactor);
+  }
+#endif
+  return SelectBestChildScalar(statistics, first, count, explorationFactor);
+}
+
+uint32_t SelectBestChildScalar(NodeStatistics const & statistics, uint32_t first, uint32_t count, float explorationFactor)
+{
+  float    bestScore = -INFINITY;
+  uint32_t bestChild = 0;
+  for (uint32_t i = first; i < first + count; i++)
+  {
+    float virtualLoss = LoadStatistic(statistics.virtualLosses[i]);
+    float visits      = LoadStatistic(statistics.visitCounts[i]) + virtualLoss;
+    float score       = (LoadStatistic(statistics.values[i]) - virtualLoss) / (visits + 1e-3F)
+                     + explorationFactor * LoadStatistic(statistics.priorProbabilities[i]) / (visits + 1.0F);
+    if (score > bestScore)
+    {
+      bestScore = score;
+      bestChild = i - first;
+    }
+  }
+  return bestChild;
+}
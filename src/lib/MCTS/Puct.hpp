@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include "NodeStatistics.hpp"
+
+/**
+ * @brief Calculates the part of the PUCT exploration term that only depends on the parent,
+ * so it can be computed once per node instead of once per child.
+ */
+float GetExplorationFactor(float parentVisitCount);
+float GetExplorationFactor(uint32_t parentVisitCount); // looked up in a precomputed table for the usual visit counts
+
+/**
+ * @brief Returns the offset (relative to first) of the child with the highest Q+U score.
+ * Uses AVX2 when the CPU supports it, otherwise falls back to SelectBestChildScalar. Ties are resolved to the first child.
+ */
+uint32_t SelectBestChild(NodeStatistics const & statistics, uint32_t first, uint32_t count, float explorationFactor);
+uint32_t SelectBestChildScalar(NodeStatistics const & statistics, uint32_t first, uint32_t count, float explorationFactor);
@@ -0,0 +1,117 @@
+#include "TranspositionTable.hpp"
+
+#include <bit>
+
+TranspositionTable::TranspositionTable(size_t capacity)
+{
+  if (capacity < BUCKET_SIZE)
+  {
+    throw std::runtime_error("Transposition table needs room for at least " + std::to_string(BUCKET_SIZE) + " positions");
+  }
+  size_t buckets = std::bit_ceil(capacity / BUCKET_SIZE);
+  m_bucketMask   = buckets - 1;
+  m_slots.resize(buckets * BUCKET_SIZE);
+}
+
+std::optional<TranspositionTable::Entry> TranspositionTable::Find(uint64_t hash)
+{
+  size_t                      bucket = GetBucket(hash);
+  std::lock_guard<std::mutex> lock(GetLock(bucket));
+  for (size_t i = bucket * BUCKET_SIZE; i < (bucket + 1) * BUCKET_SIZE; i++)
+  {
+    if (m_slots[i].occupied && m_slots[i].hash == hash)
+    {
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return m_slots[i].entry;
+    }
+  }
+  return std::nullopt;
+}
+
+void TranspositionTable::Store(uint64_t hash, torch::Tensor const & policy, float value)
+{
+  size_t                      bucket = GetBucket(hash);
+  std::lock_guard<std::mutex> lock(GetLock(bucket));
+  Slot *                      target = nullptr;
+  for (size_t i = bucket * BUCKET_SIZE; i < (bucket + 1) * BUCKET_SIZE; i++)
+  {
+    Slot & slot = m_slots[i];
+    if (slot.occupied && slot.hash == hash)
+    {
+      // another node already stored this position, keep its statistics
+      return;
+    }
+    // prefer an empty slot, otherwise replace the position with the least visits
+    if (target == nullptr || (target->occupied && (!slot.occupied || slot.entry.visitCount < target->entry.visitCount)))
+    {
+      target = &slot;
+    }
+  }
+  if (target->occupied)
+  {
+    m_replaced.fetch_add(1, std::memory_order_relaxed);
+  }
+  target->hash     = hash;
+  target->occupied = true;
+  // the policy can be a row of a batch, clone it so the rest of the batch can be freed
+  target->entry = Entry{
+    .policy     = policy.clone(),
+    .value      = value,
+    .visitCount = 0,
+    .valueSum   = 0,
+  };
+}
+
+void TranspositionTable::AddValue(uint64_t hash, float value)
+{
+  size_t                      bucket = GetBucket(hash);
+  std::lock_guard<std::mutex> lock(GetLock(bucket));
+  for (size_t i = bucket * BUCKET_SIZE; i < (bucket + 1) * BUCKET_SIZE; i++)
+  {
+    if (m_slots[i].occupied && m_slots[i].hash == hash)
+    {
+      m_slots[i].entry.visitCount++;
+      m_slots[i].entry.valueSum += value;
+      return;
+    }
+  }
+}
+
+void TranspositionTable::Clear()
+{
+  for (size_t bucket = 0; bucket <= m_bucketMask; bucket++)
+  {
+    std::lock_guard<std::mutex> lock(GetLock(bucket));
+    for (size_t i = bucket * BUCKET_SIZE; i < (bucket + 1) * BUCKET_SIZE; i++)
+    {
+      m_slots[i] = Slot{};
+    }
+  }
+  m_hits.store(0, std::memory_order_relaxed);
+  m_replaced.store(0, std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::GetCapacity() const
+{
+  return m_slots.size();
+}
+
+uint TranspositionTable::GetHits() const
+{
+  return m_hits.load(std::memory_order_relaxed);
+}
+
+uint TranspositionTable::GetReplaced() const
+{
+  return m_replaced.load(std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::GetBucket(uint64_t hash) const
+{
+  return hash & m_bucketMask;
+}
+
+std::mutex & TranspositionTable::GetLock(size_t bucket) const
+{
+  return m_locks[bucket % LOCK_COUNT];
+}
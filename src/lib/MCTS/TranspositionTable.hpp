@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <torch/torch.h>
+
+/**
+ * @brief Bounded hash table of positions, shared by all nodes in the tree that reach the same position.
+ * Stores the network evaluation of a position, so it only has to be evaluated once, and the statistics of all simulations
+ * that passed through it. Entries are stored in buckets of two, when a bucket is full the entry with the least visits is replaced.
+ */
+class TranspositionTable
+{
+public:
+  struct Entry
+  {
+    torch::Tensor policy;         // policy output of the network for this position
+    float         value      = 0; // value output of the network for this position
+    uint          visitCount = 0; // amount of simulations through this position, over all nodes that reach it
+    float         valueSum   = 0; // sum of the values of those simulations
+  };
+
+private:
+  static size_t constexpr BUCKET_SIZE = 2;
+  static size_t constexpr LOCK_COUNT  = 64;
+
+  struct Slot
+  {
+    uint64_t hash     = 0;
+    bool     occupied = false;
+    Entry    entry;
+  };
+
+  std::vector<Slot>                          m_slots;
+  size_t                                     m_bucketMask;   // amount of buckets - 1, the amount of buckets is a power of two
+  mutable std::array<std::mutex, LOCK_COUNT> m_locks;        // every lock guards a part of the buckets
+  std::atomic<uint>                          m_hits     = 0; // amount of times an evaluation was found in the table
+  std::atomic<uint>                          m_replaced = 0; // amount of entries that were replaced by another position
+
+public:
+  explicit TranspositionTable(size_t capacity);
+  ~TranspositionTable() = default;
+
+  std::optional<Entry> Find(uint64_t hash);
+  void                 Store(uint64_t hash, torch::Tensor const & policy, float value);
+  void                 AddValue(uint64_t hash, float value);
+  void                 Clear();
+
+  size_t GetCapacity() const;
+  uint   GetHits() const;
+  uint   GetReplaced() const;
+
+private:
+  size_t       GetBucket(uint64_t hash) const;
+  std::mutex & GetLock(size_t bucket) const;
+};
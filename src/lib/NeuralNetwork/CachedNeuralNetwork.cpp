@@ -0,0 +1,135 @@
+#include "CachedNeuralNetwork.hpp"
+
+#include "../Logging/Logger.hpp"
+#include "../Utilities/Hash.hpp"
+
+CachedNeuralNetwork::CachedNeuralNetwork(std::shared_ptr<NeuralNetworkInterface> network, size_t capacity)
+  : m_network(std::move(network))
+  , m_capacity(capacity)
+{
+  if (m_network == nullptr)
+  {
+    throw std::runtime_error("Cached network needs a network to evaluate positions with");
+  }
+  if (m_capacity == 0)
+  {
+    throw std::runtime_error("Evaluation cache capacity must be at least 1");
+  }
+  m_index.reserve(m_capacity);
+}
+
+Network CachedNeuralNetwork::GetNetwork()
+{
+  return m_network->GetNetwork();
+}
+
+std::pair<torch::Tensor, torch::Tensor> CachedNeuralNetwork::Predict(torch::Tensor & input)
+{
+  auto batchSize = input.size(0);
+
+  std::vector<uint64_t>      hashes(batchSize);
+  std::vector<torch::Tensor> policies(batchSize);
+  std::vector<torch::Tensor> values(batchSize);
+  std::vector<int64_t>       misses;
+  // copy the batch to the cpu once, the rows are hashed in place from it
+  auto cpuInput = input.to(torch::kCPU).contiguous();
+  for (int64_t i = 0; i < batchSize; i++)
+  {
+    hashes[i] = HashInput(cpuInput, i);
+    if (!Find(hashes[i], policies[i], values[i]))
+    {
+      misses.emplace_back(i);
+    }
+  }
+  m_hits.fetch_add(batchSize - misses.size(), std::memory_order_relaxed);
+  m_misses.fetch_add(misses.size(), std::memory_order_relaxed);
+
+  if (!misses.empty())
+  {
+    // only evaluate the positions that weren't cached, with a single call to the network
+    auto missedInput = misses.size() == (size_t)batchSize ? input : input.index_select(0, torch::tensor(misses, torch::kInt64).to(input.device()));
+    auto [policyOutput, valueOutput] = m_network->Predict(missedInput);
+    for (size_t i = 0; i < misses.size(); i++)
+    {
+      // clone the rows, so the cache doesn't keep the whole batch alive
+      policies[misses[i]] = policyOutput[(int64_t)i].clone();
+      values[misses[i]]   = valueOutput[(int64_t)i].clone();
+      Insert(hashes[misses[i]], policies[misses[i]], values[misses[i]]);
+    }
+  }
+  return std::make_pair(torch::stack(policies), torch::stack(values));
+}
+
+void CachedNeuralNetwork::LoadModel(std::filesystem::path const & folder)
+{
+  m_network->LoadModel(folder);
+  // the cached outputs belong to the previous model
+  Clear();
+}
+
+std::filesystem::path CachedNeuralNetwork::SaveModel(std::filesystem::path const & folder)
+{
+  return m_network->SaveModel(folder);
+}
+
+void CachedNeuralNetwork::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+}
+
+size_t CachedNeuralNetwork::GetSize()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+EvaluationCacheStatistics CachedNeuralNetwork::GetStatistics() const
+{
+  return EvaluationCacheStatistics{
+    .hits      = m_hits.load(std::memory_order_relaxed),
+    .misses    = m_misses.load(std::memory_order_relaxed),
+    .evictions = m_evictions.load(std::memory_order_relaxed),
+  };
+}
+
+uint64_t CachedNeuralNetwork::HashInput(torch::Tensor const & batch, int64_t index)
+{
+  // the input of the network encodes the whole position, including the player to move
+  size_t rowBytes = batch.nbytes() / (size_t)batch.size(0);
+  return HashBytes(static_cast<char const *>(batch.data_ptr()) + (size_t)index * rowBytes, rowBytes);
+}
+
+bool CachedNeuralNetwork::Find(uint64_t hash, torch::Tensor & policy, torch::Tensor & value)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto                        it = m_index.find(hash);
+  if (it == m_index.end())
+  {
+    return false;
+  }
+  // move the entry to the front, so it is evicted last
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  policy = it->second->policy;
+  value  = it->second->value;
+  return true;
+}
+
+void CachedNeuralNetwork::Insert(uint64_t hash, torch::Tensor const & policy, torch::Tensor const & value)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_index.contains(hash))
+  {
+    // another thread evaluated the same position at the same time
+    return;
+  }
+  if (m_entries.size() >= m_capacity)
+  {
+    m_index.erase(m_entries.back().hash);
+    m_entries.pop_back();
+    m_evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_entries.emplace_front(CacheEntry{hash, policy, value});
+  m_index[hash] = m_entries.begin();
+}
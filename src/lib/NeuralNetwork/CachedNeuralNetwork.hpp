@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "NeuralNetworkInterface.hpp"
+
+struct EvaluationCacheStatistics
+{
+  uint64_t hits      = 0; // positions that were answered from the cache
+  uint64_t misses    = 0; // positions that had to be evaluated by the network
+  uint64_t evictions = 0; // positions that were removed from the cache to make room for new ones
+};
+
+/**
+ * @brief Wraps another network and caches its output per position.
+ * Every row of the input is hashed, and only the rows that are not in the cache are sent to the wrapped network.
+ * The cache has a fixed capacity and evicts the least recently used position when it is full.
+ * It is cleared when a new model is loaded through this wrapper.
+ * Loading a model into the wrapped network directly leaves the old outputs in the cache, call Clear() after doing so.
+ */
+class CachedNeuralNetwork : public NeuralNetworkInterface
+{
+private:
+  struct CacheEntry
+  {
+    uint64_t      hash;
+    torch::Tensor policy;
+    torch::Tensor value;
+  };
+
+  std::shared_ptr<NeuralNetworkInterface> m_network;  // the network that evaluates the positions which are not cached
+  size_t                                  m_capacity; // maximum amount of cached positions
+
+  std::list<CacheEntry>                                         m_entries; // most recently used entries first
+  std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> m_index;   // position hash to its entry
+  std::mutex                                                    m_mutex;   // guards the entries, multiple search threads share the cache
+
+  std::atomic<uint64_t> m_hits      = 0;
+  std::atomic<uint64_t> m_misses    = 0;
+  std::atomic<uint64_t> m_evictions = 0;
+
+public:
+  CachedNeuralNetwork(std::shared_ptr<NeuralNetworkInterface> network, size_t capacity);
+  ~CachedNeuralNetwork() override = default;
+
+  Network GetNetwork() override;
+
+  std::pair<torch::Tensor, torch::Tensor> Predict(torch::Tensor & input) override;
+
+  void                  LoadModel(std::filesystem::path const & folder) override;
+  std::filesystem::path SaveModel(std::filesystem::path const & folder) override;
+
+  void                      Clear();
+  size_t                    GetSize();
+  EvaluationCacheStatistics GetStatistics() const;
+
+private:
+  // hash a row of a batch that is already contiguous on the cpu
+  static uint64_t HashInput(torch::Tensor const & batch, int64_t index);
+
+  bool Find(uint64_t hash, torch::Tensor & policy, torch::Tensor & value);
+  void Insert(uint64_t hash, torch::Tensor const & policy, torch::Tensor const & value);
+};
@@ -0,0 +1,111 @@
+#include "EvaluationQueue.hpp"
+
+#include <chrono>
+
+EvaluationQueue::EvaluationQueue(NeuralNetworkInterface & network, size_t maxBatchSize)
+  : m_network(network)
+  , m_maxBatchSize(maxBatchSize)
+{
+  if (m_maxBatchSize == 0)
+  {
+    throw std::runtime_error("Evaluation queue batch size must be at least 1");
+  }
+  m_thread = std::thread(&EvaluationQueue::Run, this);
+}
+
+EvaluationQueue::~EvaluationQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_one();
+  m_thread.join();
+}
+
+std::future<Evaluation> EvaluationQueue::Submit(torch::Tensor input)
+{
+  std::future<Evaluation> future;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.emplace_back(Request{std::move(input), std::promise<Evaluation>()});
+    future = m_requests.back().promise.get_future();
+  }
+  m_condition.notify_one();
+  return future;
+}
+
+Evaluation EvaluationQueue::Wait(std::future<Evaluation> & evaluation)
+{
+  auto start  = std::chrono::steady_clock::now();
+  auto result = evaluation.get();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_statistics.waitTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+EvaluationQueueStatistics EvaluationQueue::GetStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_statistics;
+}
+
+void EvaluationQueue::Run()
+{
+  std::vector<Request>       batch;
+  std::vector<torch::Tensor> inputs;
+  while (true)
+  {
+    batch.clear();
+    inputs.clear();
+    {
+      auto                         waitStart = std::chrono::steady_clock::now();
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_stop || !m_requests.empty(); });
+      m_statistics.idleTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - waitStart).count();
+      if (m_requests.empty())
+      {
+        // stopped, and every request has been answered
+        return;
+      }
+      // don't wait for a full batch: the requests that arrive during this call are evaluated in the next one
+      while (!m_requests.empty() && batch.size() < m_maxBatchSize)
+      {
+        batch.emplace_back(std::move(m_requests.front()));
+        m_requests.pop_front();
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto const & request: batch)
+    {
+      inputs.emplace_back(request.input);
+    }
+    torch::Tensor policyOutput;
+    torch::Tensor valueOutput;
+    try
+    {
+      auto input = torch::cat(inputs, 0);
+      std::tie(policyOutput, valueOutput) = m_network.Predict(input);
+    }
+    catch (...)
+    {
+      // the search threads rethrow the exception when they get the result
+      for (auto & request: batch)
+      {
+        request.promise.set_exception(std::current_exception());
+      }
+      continue;
+    }
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+      batch[i].promise.set_value(Evaluation{policyOutput[(int64_t)i], valueOutput[(int64_t)i].item<float>()});
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statistics.busyTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    m_statistics.batches++;
+    m_statistics.evaluations += batch.size();
+  }
+}
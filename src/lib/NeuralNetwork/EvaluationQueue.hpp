@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "NeuralNetworkInterface.hpp"
+
+struct Evaluation
+{
+  torch::Tensor policy; // policy output of a single position
+  float         value;  // value output of a single position
+};
+
+struct EvaluationQueueStatistics
+{
+  float    idleTime    = 0.0F; // seconds the inference thread waited for requests
+  float    busyTime    = 0.0F; // seconds the inference thread spent running the network
+  float    waitTime    = 0.0F; // seconds the search threads waited for results, summed over all threads
+  uint64_t batches     = 0;    // amount of network calls
+  uint64_t evaluations = 0;    // amount of positions evaluated over all network calls
+};
+
+/**
+ * @brief Evaluates positions on its own inference thread, so the search can continue while the network runs.
+ * Submitted positions are answered through a future, which can be waited on with Wait to measure how long the search was blocked.
+ * Every network call evaluates all positions that are waiting,
+ * up to the maximum batch size, so the batches grow by themselves while the previous call is running.
+ * Pending positions are still evaluated when the queue is destroyed.
+ */
+class EvaluationQueue
+{
+private:
+  struct Request
+  {
+    torch::Tensor            input;
+    std::promise<Evaluation> promise;
+  };
+
+  NeuralNetworkInterface & m_network;
+  size_t                   m_maxBatchSize;
+
+  std::deque<Request>     m_requests;  // positions waiting for the next network call
+  mutable std::mutex      m_mutex;     // guards the requests and the statistics
+  std::condition_variable m_condition; // wakes up the inference thread when there are requests
+  bool                    m_stop = false;
+
+  EvaluationQueueStatistics m_statistics;
+
+  std::thread m_thread; // started last, after all other members are initialized
+
+public:
+  EvaluationQueue(NeuralNetworkInterface & network, size_t maxBatchSize);
+  ~EvaluationQueue();
+
+  EvaluationQueue(EvaluationQueue const &)             = delete;
+  EvaluationQueue & operator=(EvaluationQueue const &) = delete;
+
+  std::future<Evaluation>   Submit(torch::Tensor input);
+  Evaluation                Wait(std::future<Evaluation> & evaluation);
+  EvaluationQueueStatistics GetStatistics() const;
+
+private:
+  void Run();
+};
@@ -1,6 +1,7 @@
 #include "Trainer.hpp"
 
 #include "../Logging/Logger.hpp"
+#include "../Utilities/RandomGenerator.hpp"
 #include "Device.hpp"
 
 Trainer::Trainer(std::shared_ptr<NeuralNetworkInterface> const & network)
@@ -12,6 +13,9 @@ Trainer::Trainer(std::shared_ptr<NeuralNetworkInterface> const & network)
 
 void Trainer::Train(Dataset const & dataset, TrainOptions const & trainOptions)
 {
+  // the random sampler shuffles with the generator of torch, seed it from the stream of this thread so the order can be repeated
+  torch::manual_seed(RandomGenerator::generator());
+
   // create data loader
   auto options    = torch::data::DataLoaderOptions().batch_size(trainOptions.batchSize).workers(4);
   auto dataLoader = torch::data::make_data_loader<torch::data::samplers::RandomSampler>(dataset, options);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+
+// Mix the bits of a 64-bit number (splitmix64 finalizer)
+constexpr uint64_t MixBits(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Hash a block of memory, 8 bytes at a time
+inline uint64_t HashBytes(void const * data, size_t size)
+{
+  auto const * bytes = static_cast<unsigned char const *>(data);
+  uint64_t     hash  = MixBits(size);
+  for (size_t i = 0; i < size; i += sizeof(uint64_t))
+  {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + i, std::min(sizeof(uint64_t), size - i));
+    hash = MixBits(hash ^ word);
+  }
+  return hash;
+}
@@ -1,17 +1,83 @@
 #pragma once
+#include <atomic>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <vector>
 
+#include "Hash.hpp"
+
+/**
+ * @brief Counter-based random number generator: the n-th number of a stream is a hash of the key of the stream and n.
+ * Streams with different keys are independent, and a stream only has to store its key and counter.
+ */
+class RandomStream
+{
+private:
+  uint64_t m_key     = 0;
+  uint64_t m_counter = 0;
+
+public:
+  using result_type = uint64_t;
+
+  RandomStream() = default;
+  explicit RandomStream(uint64_t key)
+    : m_key(key)
+  {
+  }
+
+  static constexpr result_type min()
+  {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()()
+  {
+    return MixBits(m_key ^ MixBits(m_counter++));
+  }
+};
+
+/**
+ * @brief Random numbers for the search and training. Every thread draws from its own stream,
+ * derived from the seed of the run, the game and the thread, so a run with the same seed gives the same results.
+ */
 class RandomGenerator
 {
 public:
-  static std::mt19937 generator;
+  static inline thread_local RandomStream generator;  // stream of the calling thread
+  static inline thread_local uint64_t     gameID = 0; // game the stream of the calling thread belongs to
 
   RandomGenerator() = delete;
 
-  // Reset the seed of the random generator
+  // Set the seed of the run, all streams are derived from it
+  static void SetRunSeed(uint64_t seed)
+  {
+    runSeed.store(seed, std::memory_order_relaxed);
+    SetStream(0, 0);
+  }
+
+  static uint64_t GetRunSeed()
+  {
+    return runSeed.load(std::memory_order_relaxed);
+  }
+
+  // Start the stream of the calling thread for the given game and thread.
+  // Search threads also pass the search they run for, so the searches of different moves don't repeat the same numbers
+  static void SetStream(uint64_t game, uint64_t threadID, uint64_t search = 0)
+  {
+    gameID    = game;
+    generator = RandomStream(MixBits(MixBits(MixBits(MixBits(GetRunSeed()) ^ game) ^ search) ^ threadID));
+  }
+
+  // Reset the seed of the run to a random one
   static void ResetSeed()
   {
-    generator.seed(std::random_device{}());
+    SetRunSeed(std::random_device{}());
   }
 
   // Generate a random number between min and max (inclusive)
@@ -21,6 +87,13 @@ public:
     return distribution(generator);
   }
 
+  // Generate a float between 0 (inclusive) and 1 (exclusive)
+  static float GenerateUniform()
+  {
+    std::uniform_real_distribution<float> distribution(0.0F, 1.0F);
+    return distribution(generator);
+  }
+
   // Generate a float from a gamma distribution
   static float GenerateGamma(float alpha, float beta)
   {
@@ -45,6 +118,19 @@ public:
     return gammaVector;
   }
 
+  // Generate a vector of floats from the standard gumbel distribution
+  static std::vector<float> SampleFromGumbel(size_t size)
+  {
+    std::extreme_value_distribution<float> distribution(0.0F, 1.0F);
+    std::vector<float>                     gumbelVector;
+    gumbelVector.reserve(size);
+    for (size_t i = 0; i < size; i++)
+    {
+      gumbelVector.emplace_back(distribution(generator));
+    }
+    return gumbelVector;
+  }
+
   // Calculate dirichlet noise based on a given vector of probabilities
   static std::vector<float> CalculateDirichletNoise(std::vector<float> const & probabilities, float alpha, float beta, float dirichletFraction)
   {
@@ -63,11 +149,12 @@ public:
   // sample stochastically
   static size_t StochasticSample(std::vector<float> const & probabilities)
   {
-    ResetSeed();
     std::discrete_distribution<size_t> distribution(probabilities.begin(), probabilities.end());
     return distribution(generator);
   }
 
 private:
   std::gamma_distribution<float> m_gammaDistribution;
+
+  static inline std::atomic<uint64_t> runSeed = 0;
 };
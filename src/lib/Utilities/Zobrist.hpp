@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../Environment/Environment.hpp"
+#include "Hash.hpp"
+
+// Random 64-bit key for a piece on a cell. The keys are derived from their index, so no table of keys has to be stored
+constexpr uint64_t GetZobristKey(int64_t cell, int64_t piece)
+{
+  return MixBits((uint64_t)(cell + 1) * 4 + (uint64_t)piece);
+}
+
+// Zobrist hash of a board and the player to move, computed from scratch.
+// Environments keep the same hash up to date while moves are made, see Environment::GetHash
+inline uint64_t HashBoard(torch::Tensor const & board, Player currentPlayer)
+{
+  // the keys of index 0 are used for the player to move
+  uint64_t hash = GetZobristKey(-1, (int64_t)currentPlayer);
+
+  auto         cells     = board.to(torch::kInt64).contiguous();
+  auto const * cellsData = cells.data_ptr<int64_t>();
+  for (int64_t i = 0; i < cells.numel(); i++)
+  {
+    if (cellsData[i] != (int64_t)Player::PLAYER_NONE)
+    {
+      hash ^= GetZobristKey(i, cellsData[i]);
+    }
+  }
+  return hash;
+}
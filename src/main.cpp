@@ -6,14 +6,12 @@
 #include "lib/DataManager/DataManager.hpp"
 #include "lib/Environment/Environment_TicTacToe.hpp"
 #include "lib/Logging/Logger.hpp"
+#include "lib/NeuralNetwork/CachedNeuralNetwork.hpp"
 #include "lib/NeuralNetwork/NeuralNetwork.hpp"
 #include "lib/Utilities/RandomGenerator.hpp"
 
 Logger logger;
 
-// create static generator
-std::mt19937 RandomGenerator::generator(std::random_device{}());
-
 void CreateModel(Arguments const & arguments)
 {
   // create model
@@ -58,12 +56,21 @@ void SelfPlay(Arguments const & arguments)
     neuralNetwork = std::make_unique<NeuralNetwork>(arguments.modelFolder);
   }
 
+  // the agents share one evaluation cache, so positions evaluated in earlier games don't have to be evaluated again
+  std::shared_ptr<NeuralNetworkInterface> agentNetwork = neuralNetwork;
+  std::shared_ptr<CachedNeuralNetwork>    cachedNetwork;
+  if (gameOptions.evaluationCacheSize > 0)
+  {
+    cachedNetwork = std::make_shared<CachedNeuralNetwork>(neuralNetwork, gameOptions.evaluationCacheSize);
+    agentNetwork  = cachedNetwork;
+  }
+
   // create agents
   std::vector<std::shared_ptr<Agent>> agents;
   agents.reserve(agentOptions.agentNames.size());
   for (auto const & agentName: agentOptions.agentNames)
   {
-    agents.emplace_back(std::make_unique<Agent>(agentName, neuralNetwork));
+    agents.emplace_back(std::make_unique<Agent>(agentName, agentNetwork));
   }
 
   // keep tally of wins
@@ -71,7 +78,7 @@ void SelfPlay(Arguments const & arguments)
   uint                   totalGames = 0;
   while (true)
   {
-    Game game   = Game(std::make_unique<EnvironmentTicTacToe>(), agents, gameOptions);
+    auto game   = Game<EnvironmentTicTacToe>(std::make_shared<EnvironmentTicTacToe>(), agents, gameOptions, totalGames);
     auto winner = game.PlayGame();
     wins[winner]++;
     totalGames++;
@@ -79,6 +86,11 @@ void SelfPlay(Arguments const & arguments)
           << "  Player 1: " << wins[Player::PLAYER_1] << "\n"
           << "  Player 2: " << wins[Player::PLAYER_2] << "\n"
           << "  Draws:    " << wins[Player::PLAYER_NONE] << "\n";
+    if (cachedNetwork)
+    {
+      auto statistics = cachedNetwork->GetStatistics();
+      LINFO << "Evaluation cache: " << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions << " evictions";
+    }
   }
 }
 
@@ -104,7 +116,7 @@ void Train(Arguments const & arguments)
     {
       try
       {
-        auto newData = DataManager::LoadGame<MoveTicTacToe>(file.path());
+        auto newData = DataManager::LoadGame(file.path());
         data.insert(data.end(), newData.begin(), newData.end());
       }
       catch (std::exception const & e)
@@ -128,12 +140,13 @@ void Train(Arguments const & arguments)
 
 int main(int argc, char ** argv)
 {
-  // reset random seed
-  RandomGenerator::ResetSeed();
-
   Arguments arguments = ParseArguments(argc, argv);
   auto &    device    = Device::GetInstance(arguments.useCuda);
 
+  // all random numbers of the run are derived from this seed, so a run can be repeated by passing the same seed
+  RandomGenerator::SetRunSeed(arguments.seed.value_or(std::random_device{}()));
+  LINFO << "Random seed: " << RandomGenerator::GetRunSeed();
+
   switch (arguments.mode)
   {
   case Mode::CREATEMODEL:
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../../src/lib/Environment/Environment_TicTacToe.hpp"
+#include "../../src/lib/NeuralNetwork/CachedNeuralNetwork.hpp"
+#include "../Mocks/mock_NeuralNetwork.hpp"
+
+struct CachedNeuralNetworkFixture : public ::testing::Test
+{
+  CachedNeuralNetworkFixture()
+    : network(std::make_shared<NeuralNetworkMock>())
+    , cachedNetwork(network, 2)
+  {
+  }
+
+  std::shared_ptr<NeuralNetworkMock> network;
+  CachedNeuralNetwork                cachedNetwork;
+  EnvironmentTicTacToe               env;
+};
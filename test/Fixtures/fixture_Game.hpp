@@ -5,30 +5,46 @@
 #include "../../src/lib/Environment/Environment_TicTacToe.hpp"
 #include "../Mocks/mock_NeuralNetwork.hpp"
 
-GameOptions const GAME_OPTIONS = {
-  .saveMemory       = false,
-  .maxMoves         = 9,
-  .simsPerMove      = 100,
-  .stochasticSearch = false, // don't test stochastic search
-  .memoryFolder     = "test/data",
-};
+inline GameOptions GetTestGameOptions()
+{
+  GameOptions gameOptions;
+  gameOptions.saveMemory            = false;
+  gameOptions.maxMoves              = 9;
+  gameOptions.simsPerMove           = 100;
+  gameOptions.stochasticSearch      = false; // don't test stochastic search
+  gameOptions.memoryFolder          = "test/data";
+  gameOptions.dirichletNoiseOptions = DirichletNoiseOptions{.enable = false};
+  return gameOptions;
+}
 
 struct GameFixture : public ::testing::Test
 {
   GameFixture()
     : environment(std::make_shared<EnvironmentTicTacToe>())
-    , neuralNetwork(NeuralNetworkMock())
-    , agent1(std::make_unique<Agent>("X", neuralNetwork))
-    , agent2(std::make_unique<Agent>("O", neuralNetwork))
-    , game(environment, std::move(agent1), std::move(agent2), GAME_OPTIONS)
+    , neuralNetwork(std::make_shared<NeuralNetworkMock>())
+    , agent1(std::make_shared<Agent>("X", neuralNetwork))
+    , agent2(std::make_shared<Agent>("O", neuralNetwork))
+    , game(environment, {agent1, agent2}, GetTestGameOptions())
   {
   }
 
   ~GameFixture() override = default;
 
-  std::shared_ptr<Environment> environment;
-  NeuralNetworkMock            neuralNetwork;
-  std::unique_ptr<Agent>       agent1;
-  std::unique_ptr<Agent>       agent2;
-  Game                         game;
-};
\ No newline at end of file
+  std::shared_ptr<EnvironmentTicTacToe> environment;
+  std::shared_ptr<NeuralNetworkMock>    neuralNetwork;
+  std::shared_ptr<Agent>                agent1;
+  std::shared_ptr<Agent>                agent2;
+  Game<EnvironmentTicTacToe>            game;
+};
+
+// every move searches a fresh tree, so the simulations requested for a move tell a fast search from a full one
+inline GameOptions GetPlayoutCapGameOptions(float fullSearchProbability)
+{
+  GameOptions gameOptions             = GetTestGameOptions();
+  gameOptions.reuseTree               = false;
+  gameOptions.playoutCapRandomization = true;
+  gameOptions.fastSimsPerMove         = 10;
+  gameOptions.fullSearchProbability   = fullSearchProbability;
+  gameOptions.dirichletNoiseOptions   = DirichletNoiseOptions{.alpha = 0.3F, .beta = 1.0F, .dirichletFraction = 0.25F};
+  return gameOptions;
+}
@@ -2,21 +2,76 @@
 
 #include <gtest/gtest.h>
 
+#include "../../src/lib/Environment/Environment_TicTacToe.hpp"
 #include "../../src/lib/MCTS/MCTS.hpp"
 #include "../Mocks/mock_Environment.hpp"
+#include "../Mocks/mock_NeuralNetwork.hpp"
 
 using ::testing::_;
 
 struct MCTSFixture : public ::testing::Test
 {
   MCTSFixture()
-    : env(std::make_shared<MockEnvironment>())
-    , mcts(std::make_shared<Node>(env), DirichletNoiseOptions{0.3F, 1.0F})
+    : env(CreateMockEnvironment(fake))
+    , mcts(*env, DirichletNoiseOptions{.alpha = 0.3F, .beta = 1.0F, .dirichletFraction = 0.25F})
   {
   }
 
   ~MCTSFixture() override = default;
 
-  std::shared_ptr<Environment> env;
-  MCTS                         mcts;
+  // the search only reaches the mock through Clone, so it runs on copies of the fake, which the mock also forwards SetBoard to
+  static std::shared_ptr<MockEnvironment> CreateMockEnvironment(EnvironmentTicTacToe & fake)
+  {
+    auto env = std::make_shared<MockEnvironment>();
+    ON_CALL(*env, Clone()).WillByDefault([&fake]() { return fake.Clone(); });
+    ON_CALL(*env, SetBoard(_, _)).WillByDefault([&fake](torch::Tensor const & board, Player currentPlayer) { fake.SetBoard(board, currentPlayer); });
+    EXPECT_CALL(*env, Clone()).Times(::testing::AnyNumber());
+    return env;
+  }
+
+  EnvironmentTicTacToe             fake;
+  std::shared_ptr<MockEnvironment> env;
+  MCTS<PolymorphicEnvironment>     mcts;
+};
+
+
+struct MCTSTicTacToeFixture : public ::testing::Test
+{
+  MCTSTicTacToeFixture()
+    : env(std::make_shared<EnvironmentTicTacToe>())
+  {
+    torch::Tensor board = torch::zeros({3, 3});
+    /*
+    -------------
+    |   |   | O |
+    -------------
+    | X |   |   |
+    -------------
+    | X | O |   |
+    -------------
+    */
+    board[0][2] = 2;
+    board[1][0] = 1;
+    board[2][0] = 1;
+    board[2][1] = 2;
+    env->SetBoard(board, Player::PLAYER_1);
+  }
+
+  ~MCTSTicTacToeFixture() override = default;
+
+  std::shared_ptr<EnvironmentTicTacToe> env;
+  NeuralNetworkMock                     network;
+};
+
+struct SearchMode
+{
+  std::string   name; // part of the name of the test
+  SearchOptions searchOptions;
+};
+
+// runs the same test for every way the search can be configured
+struct MCTSSearchModeFixture
+  : public MCTSTicTacToeFixture
+  , public ::testing::WithParamInterface<SearchMode>
+{
 };
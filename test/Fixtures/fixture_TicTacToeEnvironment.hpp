@@ -19,10 +19,10 @@ struct EnvironmentTicTacToeFixtureRandomMovesPlayed : EnvironmentTicTacToeFixtur
 {
   EnvironmentTicTacToeFixtureRandomMovesPlayed()
   {
-    env.MakeMove(MoveTicTacToe(0, 0));
-    env.MakeMove(MoveTicTacToe(0, 1));
-    env.MakeMove(MoveTicTacToe(2, 1));
-    env.MakeMove(MoveTicTacToe(2, 2));
+    env.MakeMove(Move(0, 0));
+    env.MakeMove(Move(0, 1));
+    env.MakeMove(Move(2, 1));
+    env.MakeMove(Move(2, 2));
     /*
     Board:
     *  -------------
@@ -40,11 +40,11 @@ struct EnvironmentTicTacToeFixturePlayerXHasWon : EnvironmentTicTacToeFixture
 {
   EnvironmentTicTacToeFixturePlayerXHasWon()
   {
-    env.MakeMove(MoveTicTacToe(0, 0));
-    env.MakeMove(MoveTicTacToe(1, 0));
-    env.MakeMove(MoveTicTacToe(0, 1));
-    env.MakeMove(MoveTicTacToe(1, 1));
-    env.MakeMove(MoveTicTacToe(0, 2));
+    env.MakeMove(Move(0, 0));
+    env.MakeMove(Move(1, 0));
+    env.MakeMove(Move(0, 1));
+    env.MakeMove(Move(1, 1));
+    env.MakeMove(Move(0, 2));
     /* Board:
      *  -------------
      *  | X | X | X |
@@ -61,15 +61,15 @@ struct EnvironmentTicTacToeFixtureBoardFull : EnvironmentTicTacToeFixture
 {
   EnvironmentTicTacToeFixtureBoardFull()
   {
-    env.MakeMove(MoveTicTacToe(0, 0));
-    env.MakeMove(MoveTicTacToe(0, 1));
-    env.MakeMove(MoveTicTacToe(0, 2));
-    env.MakeMove(MoveTicTacToe(1, 0));
-    env.MakeMove(MoveTicTacToe(1, 1));
-    env.MakeMove(MoveTicTacToe(1, 2));
-    env.MakeMove(MoveTicTacToe(2, 0));
-    env.MakeMove(MoveTicTacToe(2, 1));
-    env.MakeMove(MoveTicTacToe(2, 2));
+    env.MakeMove(Move(0, 0));
+    env.MakeMove(Move(0, 1));
+    env.MakeMove(Move(0, 2));
+    env.MakeMove(Move(1, 0));
+    env.MakeMove(Move(1, 1));
+    env.MakeMove(Move(1, 2));
+    env.MakeMove(Move(2, 0));
+    env.MakeMove(Move(2, 1));
+    env.MakeMove(Move(2, 2));
     /* Board:
      *  -------------
      *  | X | X | X |
@@ -22,22 +22,25 @@ public:
   MOCK_METHOD(void, SetCurrentPlayer, (Player player), (override));
   MOCK_METHOD(void, TogglePlayer, (), (override));
 
-  MOCK_METHOD(void, MakeMove, (Move const & move), (override));
+  MOCK_METHOD(void, MakeMove, (Move move), (override));
   MOCK_METHOD(void, UndoMove, (), (override));
   MOCK_METHOD(bool, IsValidMove, (uint row, uint column), (const, override));
 
-  MOCK_METHOD(std::vector<std::shared_ptr<Move>>, GetValidMoves, (), (const, override));
-  MOCK_METHOD(std::vector<std::shared_ptr<Move>> const &, GetMoveHistory, (), (const, override));
+  MOCK_METHOD(MoveList, GetValidMoves, (), (const, override));
+  MOCK_METHOD(std::vector<Move> const &, GetMoveHistory, (), (const, override));
 
   MOCK_METHOD(int, GetRows, (), (const, override));
   MOCK_METHOD(int, GetColumns, (), (const, override));
 
   MOCK_METHOD(Player, GetPlayerAtCoordinates, (uint row, uint column), (const, override));
 
-  MOCK_METHOD(torch::Tensor const &, GetBoard, (), (const, override));
+  MOCK_METHOD(torch::Tensor, GetBoard, (), (const, override));
   MOCK_METHOD(void, SetBoard, (torch::Tensor const & board, Player currentPlayer), (override));
 
   MOCK_METHOD(torch::Tensor, BoardToInput, (), (const, override));
+  MOCK_METHOD(void, BoardToInput, (torch::Tensor & batch, int64_t index), (const, override));
+  MOCK_METHOD(int, GetInputPlanes, (), (const, override));
+  MOCK_METHOD(uint64_t, GetHash, (), (const, override));
 
   MOCK_METHOD(bool, IsTerminal, (), (const, override));
   MOCK_METHOD(Player, GetWinner, (), (const, override));
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "../Fixtures/fixture_CachedNeuralNetwork.hpp"
+
+TEST_F(CachedNeuralNetworkFixture, Predict_SamePositionTwice_EvaluatesOnce)
+{
+  EXPECT_CALL(*network, Predict(_)).Times(1);
+
+  auto input = env.BoardToInput();
+  auto [policy1, value1] = cachedNetwork.Predict(input);
+  auto [policy2, value2] = cachedNetwork.Predict(input);
+
+  ASSERT_TRUE(torch::equal(policy1, policy2));
+  ASSERT_TRUE(torch::equal(value1, value2));
+  ASSERT_EQ(cachedNetwork.GetStatistics().hits, 1);
+  ASSERT_EQ(cachedNetwork.GetStatistics().misses, 1);
+}
+
+TEST_F(CachedNeuralNetworkFixture, Predict_BatchWithCachedRow_OnlyEvaluatesMisses)
+{
+  auto input = env.BoardToInput();
+  cachedNetwork.Predict(input);
+
+  env.MakeMove(Move(1, 1));
+  auto batch = torch::cat({input, env.BoardToInput()}, 0);
+  EXPECT_CALL(*network, Predict(_)).WillOnce(Invoke([](torch::Tensor & missedInput) { //
+    EXPECT_EQ(missedInput.size(0), 1);
+    return std::make_pair(torch::ones({1, 9}), torch::ones({1, 1}));
+  }));
+  auto [policy, value] = cachedNetwork.Predict(batch);
+
+  ASSERT_EQ(policy.size(0), 2);
+  ASSERT_EQ(value.size(0), 2);
+}
+
+TEST_F(CachedNeuralNetworkFixture, Predict_FullCache_EvictsLeastRecentlyUsed)
+{
+  // the fixture's cache holds two positions
+  for (auto const & move: {Move(0, 0), Move(1, 1), Move(2, 2)})
+  {
+    env.MakeMove(move);
+    auto input = env.BoardToInput();
+    cachedNetwork.Predict(input);
+  }
+  ASSERT_EQ(cachedNetwork.GetSize(), 2);
+  ASSERT_EQ(cachedNetwork.GetStatistics().evictions, 1);
+}
+
+TEST_F(CachedNeuralNetworkFixture, LoadModel_ClearsCache)
+{
+  auto input = env.BoardToInput();
+  cachedNetwork.Predict(input);
+  ASSERT_EQ(cachedNetwork.GetSize(), 1);
+
+  EXPECT_CALL(*network, LoadModel(_)).Times(1);
+  cachedNetwork.LoadModel("model");
+  ASSERT_EQ(cachedNetwork.GetSize(), 0);
+}
+
+TEST_F(CachedNeuralNetworkFixture, Predict_CachedSecondRow_EvaluatesFirstRow)
+{
+  auto first = env.BoardToInput();
+  env.MakeMove(Move(1, 1));
+  auto second = env.BoardToInput();
+  cachedNetwork.Predict(second);
+
+  auto batch = torch::cat({first, second}, 0);
+  EXPECT_CALL(*network, Predict(_)).WillOnce(Invoke([&first](torch::Tensor & missedInput) { //
+    EXPECT_TRUE(torch::equal(missedInput, first));
+    return std::make_pair(torch::ones({1, 9}), torch::ones({1, 1}));
+  }));
+  cachedNetwork.Predict(batch);
+
+  ASSERT_EQ(cachedNetwork.GetStatistics().hits, 1);
+}
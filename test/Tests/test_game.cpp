@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "../Fixtures/fixture_Game.hpp"
+#include "../../src/lib/Utilities/RandomGenerator.hpp"
+
+TEST_F(GameFixture, Game_ReuseTree_KeepsVisitsOfPlayedMove)
+{
+  game.PlayMove();
+  // both agents use the same network, so they search the same tree
+  auto const & tree = game.GetTree(Player::PLAYER_2);
+  ASSERT_EQ(&tree, &game.GetTree(Player::PLAYER_1));
+  uint reusedVisits = tree.GetRoot().GetVisitCount();
+  ASSERT_GT(reusedVisits, 0);
+
+  // the second search only runs the simulations that the reused subtree didn't have yet
+  game.PlayMove();
+  ASSERT_EQ(game.GetSimulationsRequested(), 2 * GetTestGameOptions().simsPerMove - reusedVisits);
+}
+
+TEST_F(GameFixture, Game_ReuseTree_PositionChanged_ResetsRoot)
+{
+  game.PlayMove();
+  ASSERT_GT(game.GetTree(Player::PLAYER_2).GetRoot().GetVisitCount(), 0);
+
+  // a position that can't follow the first move, so the hash of the environment no longer matches the root
+  torch::Tensor board = torch::zeros({3, 3});
+  board[0][0] = 1;
+  board[1][1] = 2;
+  board[2][2] = 1;
+  environment->SetBoard(board, Player::PLAYER_2);
+  ASSERT_NE(game.GetTree(Player::PLAYER_2).GetRootEnvironment().GetHash(), environment->GetHash());
+
+  game.PlayMove();
+  ASSERT_EQ(game.GetSimulationsRequested(), 2 * GetTestGameOptions().simsPerMove);
+}
+
+TEST_F(GameFixture, Game_ReuseTree_DifferentNetworks_SeparateTrees)
+{
+  auto otherNetwork = std::make_shared<NeuralNetworkMock>();
+  auto otherAgent   = std::make_shared<Agent>("O", otherNetwork);
+  auto otherGame    = Game<EnvironmentTicTacToe>(environment, {agent1, otherAgent}, GetTestGameOptions());
+  ASSERT_NE(&otherGame.GetTree(Player::PLAYER_1), &otherGame.GetTree(Player::PLAYER_2));
+
+  // the tree of the second agent was never searched, so it starts the next search without visits of the first network
+  otherGame.PlayMove();
+  ASSERT_EQ(otherGame.GetTree(Player::PLAYER_2).GetRoot().GetVisitCount(), 0);
+  otherGame.PlayMove();
+  ASSERT_EQ(otherGame.GetSimulationsRequested(), 2 * GetTestGameOptions().simsPerMove);
+}
+
+TEST_F(GameFixture, Game_PlayoutCap_NeverFullSearch_UsesFastSearches)
+{
+  auto gameOptions = GetPlayoutCapGameOptions(0.0F);
+  auto fastGame    = Game<EnvironmentTicTacToe>(environment, {agent1, agent2}, gameOptions);
+  for (uint move = 1; move <= 3; move++)
+  {
+    fastGame.PlayMove();
+    ASSERT_EQ(fastGame.GetSimulationsRequested(), move * gameOptions.fastSimsPerMove);
+    // a fast search runs without noise, and its visit counts are no training target
+    ASSERT_FALSE(fastGame.GetTree(Player::PLAYER_1).IsDirichletNoiseEnabled());
+    ASSERT_TRUE(fastGame.GetMemory().empty());
+  }
+}
+
+TEST_F(GameFixture, Game_PlayoutCap_AlwaysFullSearch_UsesFullSearches)
+{
+  auto gameOptions = GetPlayoutCapGameOptions(1.0F);
+  auto fullGame    = Game<EnvironmentTicTacToe>(environment, {agent1, agent2}, gameOptions);
+  for (uint move = 1; move <= 3; move++)
+  {
+    fullGame.PlayMove();
+    ASSERT_EQ(fullGame.GetSimulationsRequested(), move * gameOptions.simsPerMove);
+    ASSERT_TRUE(fullGame.GetTree(Player::PLAYER_1).IsDirichletNoiseEnabled());
+    ASSERT_EQ(fullGame.GetMemory().size(), move);
+  }
+}
+
+TEST_F(GameFixture, Game_PlayoutCap_Seeded_MixesFastAndFullSearches)
+{
+  // without noise the only random numbers of the game are the draws for the search type of each move,
+  // with this seed the first four draws give a fast, full, full and fast search
+  RandomGenerator::SetRunSeed(42);
+  auto gameOptions                         = GetPlayoutCapGameOptions(0.5F);
+  gameOptions.dirichletNoiseOptions.enable = false;
+  auto mixedGame                           = Game<EnvironmentTicTacToe>(environment, {agent1, agent2}, gameOptions);
+
+  std::vector<bool> expectedFullSearches = {false, true, true, false};
+  uint              requested            = 0;
+  size_t            fullSearches         = 0;
+  for (bool fullSearch: expectedFullSearches)
+  {
+    mixedGame.PlayMove();
+    requested += fullSearch ? gameOptions.simsPerMove : gameOptions.fastSimsPerMove;
+    fullSearches += fullSearch ? 1 : 0;
+    ASSERT_EQ(mixedGame.GetSimulationsRequested(), requested);
+    // only the full searches are saved to memory
+    ASSERT_EQ(mixedGame.GetMemory().size(), fullSearches);
+  }
+}
@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <numeric>
+#include <random>
+
 #include "../Fixtures/fixture_Game.hpp"
 #include "../Fixtures/fixture_MCTS.hpp"
+#include "../../src/lib/MCTS/Puct.hpp"
 
 TEST_F(GameFixture, MCTS_XWinning_XTurn_XShouldWin)
 {
@@ -176,9 +181,324 @@ TEST_F(MCTSFixture, MCTS_GetBestMove_Deterministic)
   board[2][1] = 2;
 
   env->SetBoard(board, Player::PLAYER_1);
+  mcts.ResetRoot(*env); // the search works on its own copy of the environment
+  NeuralNetworkMock network;
+  mcts.RunSimulations(200, network);
+  auto bestMove = mcts.GetBestMove(false);
+  ASSERT_EQ(bestMove.GetRow(), 0);
+  ASSERT_EQ(bestMove.GetColumn(), 0);
+}
+
+TEST_F(MCTSFixture, MCTS_ResetRoot_SearchesOwnCopy)
+{
+  // the environment is cloned once for the root, the search never plays its moves on the given environment
+  EXPECT_CALL(*env, Clone()).Times(1);
+  EXPECT_CALL(*env, MakeMove(_)).Times(0);
+  EXPECT_CALL(*env, UndoMove()).Times(0);
+  mcts.ResetRoot(*env);
   NeuralNetworkMock network;
+  mcts.RunSimulations(50, network);
+  ASSERT_EQ(mcts.GetRoot().GetVisitCount(), 50);
+}
+
+TEST_P(MCTSSearchModeFixture, MCTS_XWinning_XTurn_XShouldWin)
+{
+  auto mcts       = MCTS(*env, DirichletNoiseOptions{.enable = false}, GetParam().searchOptions);
+  auto statistics = mcts.RunSimulations(200, network);
+  ASSERT_GT(statistics.simulations, 0);
+  ASSERT_LE(statistics.simulations, 200);
+  // every virtual loss that was added while the search ran has been removed again
+  ASSERT_EQ(mcts.GetRoot().GetVirtualLoss(), 0);
+  for (auto const & child: mcts.GetChildren(mcts.GetRoot()))
+  {
+    ASSERT_EQ(child.GetVirtualLoss(), 0);
+  }
+  auto bestMove = mcts.GetBestMove(false);
+  ASSERT_EQ(bestMove.GetRow(), 0);
+  ASSERT_EQ(bestMove.GetColumn(), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(SearchModes, MCTSSearchModeFixture,
+                         ::testing::Values(SearchMode{"Sequential", {}},
+                                           SearchMode{"Batched", {.batchSize = 8}},
+                                           SearchMode{"TreeParallel", {.numThreads = 4}},
+                                           SearchMode{"Asynchronous", {.batchSize = 4, .numThreads = 2, .asynchronous = true}},
+                                           SearchMode{"RootParallel", {.numThreads = 4, .rootParallel = true}},
+                                           SearchMode{"Transpositions", {.batchSize = 8, .transpositionTableSize = 1024}},
+                                           SearchMode{"NodeBudget", {.maxNodes = 64}},
+                                           SearchMode{"Solver", {.useSolver = true}},
+                                           SearchMode{"Gumbel", {.useGumbel = true}},
+                                           SearchMode{"EarlyStop", {.stopEarly = true, .minSimulations = 50}}),
+                         [](::testing::TestParamInfo<SearchMode> const & info) { return info.param.name; });
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Batched_EvaluatesLeavesTogether)
+{
+  int64_t largestBatch = 0;
+  EXPECT_CALL(network, Predict(_))
+    .WillRepeatedly(Invoke(
+      [&largestBatch](torch::Tensor & input)
+      {
+        largestBatch = std::max(largestBatch, input.size(0));
+        return std::make_pair(torch::ones({input.size(0), input.size(1) * input.size(2)}), torch::ones({input.size(0), 1}));
+      }));
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.batchSize = 8});
+  mcts.RunSimulations(200, network);
+  ASSERT_GT(largestBatch, 1);
+  ASSERT_LE(largestBatch, 8);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_PolymorphicEnvironment_SearchesLikeConcreteEnvironment)
+{
+  // an environment that is only known through the Environment interface is searched through the virtual adapter
+  Environment const & environment = *env;
+  auto                mcts        = MCTS(environment, DirichletNoiseOptions{.enable = false});
+  static_assert(std::is_same_v<decltype(mcts), MCTS<PolymorphicEnvironment>>);
+  mcts.RunSimulations(200, network);
+  // the adapter only changes how the environment is called, so the same search visits the same moves
+  auto concrete = MCTS(*env, DirichletNoiseOptions{.enable = false});
+  concrete.RunSimulations(200, network);
+  ASSERT_EQ(mcts.GetRootVisitCounts(), concrete.GetRootVisitCounts());
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_TreeParallel_SharesOneTree)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.numThreads = 4});
+  mcts.RunSimulations(200, network);
+  // all threads searched the same tree, so its root holds every simulation
+  ASSERT_EQ(mcts.GetSimulationsRun(), 200);
+  ASSERT_EQ(mcts.GetRoot().GetVisitCount(), 200);
+  // the simulations of the threads that reached the root while it was being expanded don't reach a child
+  auto visitCounts = mcts.GetRootVisitCounts();
+  ASSERT_LE(std::accumulate(visitCounts.begin(), visitCounts.end(), 0U), 200 - 1);
+  ASSERT_GE(std::accumulate(visitCounts.begin(), visitCounts.end(), 0U), 200 - 4);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Asynchronous_NetworkThrows_RemovesVirtualLoss)
+{
+  EXPECT_CALL(network, Predict(_)).WillRepeatedly(Invoke([](torch::Tensor &) -> std::pair<torch::Tensor, torch::Tensor> { throw std::runtime_error("network failed"); }));
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.batchSize = 4, .numThreads = 2, .asynchronous = true});
+  ASSERT_THROW(mcts.RunSimulations(200, network), std::runtime_error);
+  // the leaf nodes that were still waiting for the network don't keep their virtual loss
+  ASSERT_EQ(mcts.GetRoot().GetVirtualLoss(), 0);
+  for (auto const & child: mcts.GetChildren(mcts.GetRoot()))
+  {
+    ASSERT_EQ(child.GetVirtualLoss(), 0);
+  }
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_RootParallel_MergesRootVisits)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.numThreads = 4, .rootParallel = true});
+  mcts.RunSimulations(200, network);
+  ASSERT_EQ(mcts.GetSimulationsRun(), 200);
+  // the visits of all trees are merged for the root children, the first expansion of every tree doesn't reach a child
+  auto visitCounts = mcts.GetRootVisitCounts();
+  auto children    = mcts.GetChildren(mcts.GetRoot());
+  ASSERT_EQ(visitCounts.size(), children.size());
+  ASSERT_LE(std::accumulate(visitCounts.begin(), visitCounts.end(), 0U), 200);
+  ASSERT_GE(std::accumulate(visitCounts.begin(), visitCounts.end(), 0U), 200 - 4);
+  // every merged count is the visits of this tree plus those of the other trees, and the other trees did part of the search
+  uint ownVisits = 0;
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    ASSERT_GE(visitCounts[i], children[i].GetVisitCount());
+    ownVisits += children[i].GetVisitCount();
+  }
+  ASSERT_LT(ownVisits, std::accumulate(visitCounts.begin(), visitCounts.end(), 0U));
+  // the tree itself only holds the visits of its own search
+  ASSERT_LT(mcts.GetRoot().GetVisitCount(), 200);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_RootParallel_AdvanceRoot_KeepsOwnVisits)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.batchSize = 1, .numThreads = 4, .rootParallel = true});
   mcts.RunSimulations(200, network);
   auto bestMove = mcts.GetBestMove(false);
-  ASSERT_EQ(bestMove->GetRow(), 0);
-  ASSERT_EQ(bestMove->GetColumn(), 0);
-}
\ No newline at end of file
+
+  uint childVisitCount = 0;
+  for (auto const & child: mcts.GetChildren(mcts.GetRoot()))
+  {
+    if (child.GetMove() == bestMove)
+    {
+      childVisitCount = child.GetVisitCount();
+    }
+  }
+  // the reused subtree keeps the visits it was searched with, not the ones merged from the other trees
+  ASSERT_TRUE(mcts.AdvanceRoot(bestMove));
+  ASSERT_EQ(mcts.GetRoot().GetVisitCount(), childVisitCount);
+  auto visitCounts = mcts.GetRootVisitCounts();
+  ASSERT_EQ(visitCounts.size(), mcts.GetChildren(mcts.GetRoot()).size());
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Gumbel_XWinning_XTurn_XShouldWin)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.useGumbel = true});
+  mcts.RunSimulations(32, network);
+  ASSERT_LE(mcts.GetSimulationsRun(), 32);
+  auto bestMove = mcts.GetBestMove(true);
+  ASSERT_EQ(bestMove.GetRow(), 0);
+  ASSERT_EQ(bestMove.GetColumn(), 0);
+
+  // the policy target comes from the completed Q-values, so every move gets a probability
+  auto policy   = mcts.GetPolicyTarget();
+  auto children = mcts.GetChildren(mcts.GetRoot());
+  ASSERT_EQ(policy.size(), children.size());
+  ASSERT_NEAR(std::accumulate(policy.begin(), policy.end(), 0.0F), 1.0F, 1e-5F);
+  auto best = std::max_element(policy.begin(), policy.end()) - policy.begin();
+  ASSERT_EQ(children[best].GetMove().GetRow(), 0);
+  ASSERT_EQ(children[best].GetMove().GetColumn(), 0);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Gumbel_RunsAllSimulations)
+{
+  // 9 candidates in 4 phases, an even split would only run 1 simulation per candidate and phase
+  auto mcts = MCTS(EnvironmentTicTacToe(), DirichletNoiseOptions{.enable = false}, SearchOptions{.useGumbel = true});
+  mcts.RunSimulations(60, network);
+  ASSERT_EQ(mcts.GetSimulationsRun(), 60);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_PolicyTarget_NoVisits_UsesPriors)
+{
+  // the root is expanded for the dirichlet noise, but no simulation visits its children
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.alpha = 0.3F, .beta = 1.0F, .dirichletFraction = 0.25F});
+  mcts.RunSimulations(0, network);
+  auto policy = mcts.GetPolicyTarget();
+  ASSERT_EQ(policy.size(), mcts.GetChildren(mcts.GetRoot()).size());
+  for (float probability: policy)
+  {
+    ASSERT_FALSE(std::isnan(probability));
+  }
+  ASSERT_NEAR(std::accumulate(policy.begin(), policy.end(), 0.0F), 1.0F, 1e-5F);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_NodeBudget_PrunesTree)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.maxNodes = 64});
+  mcts.RunSimulations(400, network);
+  ASSERT_EQ(mcts.GetSimulationsRun(), 400);
+  // the last expansion before the budget was reached can go over it by the children of a single node
+  ASSERT_LE(mcts.GetPeakNodes(), 64 + 5);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_AdvanceRoot_KeepsSubtree)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false});
+  mcts.RunSimulations(100, network);
+  auto bestMove = mcts.GetBestMove(false);
+
+  uint childVisitCount = 0;
+  for (auto const & child: mcts.GetChildren(mcts.GetRoot()))
+  {
+    if (child.GetMove() == bestMove)
+    {
+      childVisitCount = child.GetVisitCount();
+    }
+  }
+  ASSERT_GT(childVisitCount, 0);
+
+  ASSERT_TRUE(mcts.AdvanceRoot(bestMove));
+  ASSERT_EQ(mcts.GetRoot().GetParent(), NO_NODE);
+  ASSERT_EQ(mcts.GetRoot().GetVisitCount(), childVisitCount);
+}
+
+TEST(PuctTest, SelectBestChild_MatchesScalar)
+{
+  auto                                  statistics = std::make_unique<NodeStatistics>();
+  std::mt19937                          generator(42);
+  std::uniform_real_distribution<float> distribution(0.0F, 1.0F);
+  for (int test = 0; test < 1000; test++)
+  {
+    // random amount of children at a random offset, so both full vectors and the remainder are tested
+    uint32_t first = generator() % 64;
+    uint32_t count = 1 + generator() % 100;
+    for (uint32_t i = first; i < first + count; i++)
+    {
+      statistics->priorProbabilities[i] = distribution(generator);
+      statistics->visitCounts[i]        = (float)(generator() % 50);
+      statistics->values[i]             = (distribution(generator) * 2.0F - 1.0F) * statistics->visitCounts[i];
+      statistics->virtualLosses[i]      = (float)(generator() % 3);
+    }
+    float explorationFactor = GetExplorationFactor((float)(generator() % 1000));
+    ASSERT_EQ(SelectBestChild(*statistics, first, count, explorationFactor), SelectBestChildScalar(*statistics, first, count, explorationFactor));
+  }
+}
+
+TEST(PuctTest, ExplorationFactor_TableMatchesFormula)
+{
+  for (uint32_t visits: {0U, 1U, 2U, 100U, 19652U, 65535U, 65536U, 1000000U})
+  {
+    ASSERT_FLOAT_EQ(GetExplorationFactor(visits), GetExplorationFactor((float)visits));
+  }
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Transpositions_ResetRoot_ClearsTable)
+{
+  // on an empty board, different move orders reach the same positions
+  EnvironmentTicTacToe emptyBoard;
+  auto                 mcts       = MCTS(emptyBoard, DirichletNoiseOptions{.enable = false}, SearchOptions{.transpositionTableSize = 4096});
+  auto                 statistics = mcts.RunSimulations(400, network);
+  ASSERT_GT(statistics.transpositionHits, 0);
+  // the first search stored the root in the table, after the reset the network has to evaluate it again
+  mcts.ResetRoot(emptyBoard);
+  statistics = mcts.RunSimulations(1, network);
+  ASSERT_EQ(statistics.transpositionHits, 0);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_TerminalLeaves_SkipNetwork)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false});
+  mcts.RunSimulations(50, network);
+  // X wins immediately at (0, 0), so most simulations end in a terminal leaf
+  ASSERT_GT(mcts.GetSavedEvaluations(), 0);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Solver_ProvesWin_StopsEarly)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.useSolver = true});
+  mcts.RunSimulations(800, network);
+  // X wins immediately at (0, 0), which proves the root long before the simulations run out
+  ASSERT_LT(mcts.GetRoot().GetVisitCount(), 800);
+  for (auto const & child: mcts.GetChildren(mcts.GetRoot()))
+  {
+    if (child.GetMove().GetRow() == 0 && child.GetMove().GetColumn() == 0)
+    {
+      ASSERT_EQ(child.GetProvenValue(), 1.0F);
+    }
+  }
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_EarlyStop_StopsWhenBestMoveIsDecided)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.stopEarly = true, .minSimulations = 50});
+  mcts.RunSimulations(800, network);
+  ASSERT_GE(mcts.GetSimulationsRun(), 50);
+  ASSERT_LT(mcts.GetSimulationsRun(), 800);
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_MakeUndo_RootEnvironmentIsUnchanged)
+{
+  auto mcts = MCTS(*env, DirichletNoiseOptions{.enable = false}, SearchOptions{.batchSize = 4, .numThreads = 2});
+  mcts.RunSimulations(100, network);
+  // every move made while descending the tree has been undone again
+  ASSERT_EQ(mcts.GetRootEnvironment().GetCurrentPlayer(), env->GetCurrentPlayer());
+  ASSERT_TRUE(torch::equal(mcts.GetRootEnvironment().GetBoard(), env->GetBoard()));
+  ASSERT_EQ(mcts.GetRootEnvironment().GetMoveHistory().size(), env->GetMoveHistory().size());
+  for (auto const & child: mcts.GetChildren(mcts.GetRoot()))
+  {
+    ASSERT_TRUE(child.GetVisitCount() == 0 || child.IsPositionKnown());
+  }
+}
+
+TEST_F(MCTSTicTacToeFixture, MCTS_Statistics_AreCollected)
+{
+  auto mcts       = MCTS(*env, DirichletNoiseOptions{.enable = false});
+  auto statistics = mcts.RunSimulations(100, network);
+  ASSERT_EQ(statistics.simulations, 100);
+  ASSERT_GE(statistics.maxDepth, 1);
+  ASSERT_GE(statistics.meanLeafDepth, 1.0F);
+  ASSERT_LE(statistics.meanLeafDepth, (float)statistics.maxDepth);
+  ASSERT_GT(statistics.expansions, 0);
+  ASSERT_EQ(statistics.terminalHits, mcts.GetSavedEvaluations());
+  ASSERT_GE(statistics.peakNodeCount, statistics.nodeCount);
+  ASSERT_GT(statistics.wallTime, 0.0F);
+}
@@ -3,12 +3,9 @@
 #include "../../src/lib/Environment/Environment_TicTacToe.hpp"
 #include "../../src/lib/MCTS/Node.hpp"
 #include "../../src/lib/NeuralNetwork/NeuralNetwork.hpp"
-#include "../../src/lib/Utilities/Functions.hpp"
 #include "../../src/lib/Utilities/RandomGenerator.hpp"
 #include "../Fixtures/fixture_RandomGenerator.hpp"
 
-std::mt19937 RandomGenerator::generator(std::random_device{}());
-
 TEST_F(RandomGeneratorFixture, GenerateGamma_CheckRange)
 {
   for (int i = 0; i < 1000; i++)
@@ -106,3 +103,36 @@ TEST_F(RandomGeneratorFixture, StochasticSample)
     ASSERT_NEAR(counts[i], probabilities[i] * sampleTimes, 0.05F * sampleTimes);
   }
 }
+
+TEST(RandomStreamTest, SameSeedGameAndThread_SameNumbers)
+{
+  RandomGenerator::SetRunSeed(42);
+  RandomGenerator::SetStream(3, 1);
+  std::vector<float> first = RandomGenerator::SampleFromGamma(16, 0.3F, 1.0F);
+  RandomGenerator::SetStream(3, 1);
+  std::vector<float> second = RandomGenerator::SampleFromGamma(16, 0.3F, 1.0F);
+  ASSERT_EQ(first, second);
+}
+
+TEST(RandomStreamTest, DifferentThreads_DifferentNumbers)
+{
+  RandomGenerator::SetRunSeed(42);
+  RandomGenerator::SetStream(3, 1);
+  auto first = RandomGenerator::generator();
+  RandomGenerator::SetStream(3, 2);
+  auto second = RandomGenerator::generator();
+  RandomGenerator::SetStream(4, 1);
+  auto third = RandomGenerator::generator();
+  ASSERT_NE(first, second);
+  ASSERT_NE(first, third);
+}
+
+TEST(RandomStreamTest, DifferentSearches_DifferentNumbers)
+{
+  RandomGenerator::SetRunSeed(42);
+  RandomGenerator::SetStream(3, 1, 1);
+  auto first = RandomGenerator::generator();
+  RandomGenerator::SetStream(3, 1, 2);
+  auto second = RandomGenerator::generator();
+  ASSERT_NE(first, second);
+}
@@ -1,5 +1,6 @@
 
 #include "../../src/lib/Logging/Logger.hpp"
+#include "../../src/lib/Utilities/Zobrist.hpp"
 #include "../Fixtures/fixture_TicTacToeEnvironment.hpp"
 
 TEST_F(EnvironmentTicTacToeFixtureRandomMovesPlayed, Clone)
@@ -19,8 +20,8 @@ TEST_F(EnvironmentTicTacToeFixtureRandomMovesPlayed, Clone_CheckMoveHistory)
   ASSERT_EQ(env.GetMoveHistory().size(), clone->GetMoveHistory().size());
   for (int i = 0; i < env.GetMoveHistory().size(); i++)
   {
-    ASSERT_EQ(env.GetMoveHistory()[i]->GetRow(), clone->GetMoveHistory()[i]->GetRow());
-    ASSERT_EQ(env.GetMoveHistory()[i]->GetColumn(), clone->GetMoveHistory()[i]->GetColumn());
+    ASSERT_EQ(env.GetMoveHistory()[i].GetRow(), clone->GetMoveHistory()[i].GetRow());
+    ASSERT_EQ(env.GetMoveHistory()[i].GetColumn(), clone->GetMoveHistory()[i].GetColumn());
   }
 }
 
@@ -53,29 +54,29 @@ TEST_F(EnvironmentTicTacToeFixture, TogglePlayer)
 
 TEST_F(EnvironmentTicTacToeFixture, MakeMove)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
+  env.MakeMove(Move(0, 0));
   ASSERT_EQ(env.GetPlayerAtCoordinates(0, 0), Player::PLAYER_1);
-  env.MakeMove(MoveTicTacToe(1, 1));
+  env.MakeMove(Move(1, 1));
   ASSERT_EQ(env.GetPlayerAtCoordinates(1, 1), Player::PLAYER_2);
 }
 
 TEST_F(EnvironmentTicTacToeFixture, MakeMove_InvalidMove_RepeatMove)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
+  env.MakeMove(Move(0, 0));
   // make the same move again
-  ASSERT_THROW(env.MakeMove(MoveTicTacToe(0, 0)), std::runtime_error);
+  ASSERT_THROW(env.MakeMove(Move(0, 0)), std::runtime_error);
 }
 
 TEST_F(EnvironmentTicTacToeFixture, MakeMove_InvalidMove_BoardFull)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
-  ASSERT_THROW(env.MakeMove(MoveTicTacToe(0, 0)), std::runtime_error);
+  env.MakeMove(Move(0, 0));
+  ASSERT_THROW(env.MakeMove(Move(0, 0)), std::runtime_error);
 }
 
 TEST_F(EnvironmentTicTacToeFixture, UndoMove)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
-  env.MakeMove(MoveTicTacToe(1, 1));
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(1, 1));
   env.UndoMove();
   ASSERT_EQ(env.GetPlayerAtCoordinates(1, 1), Player::PLAYER_NONE);
   env.UndoMove();
@@ -85,19 +86,40 @@ TEST_F(EnvironmentTicTacToeFixture, UndoMove)
 TEST_F(EnvironmentTicTacToeFixture, IsValidMove)
 {
   ASSERT_TRUE(env.IsValidMove(0, 0));
-  env.MakeMove(MoveTicTacToe(0, 0));
+  env.MakeMove(Move(0, 0));
   ASSERT_FALSE(env.IsValidMove(0, 0));
 }
 
+TEST_F(EnvironmentTicTacToeFixture, IsValidMove_OutOfRange)
+{
+  ASSERT_FALSE(env.IsValidMove(3, 0));
+  ASSERT_FALSE(env.IsValidMove(0, 3));
+  ASSERT_THROW(env.MakeMove(Move(3, 0)), std::runtime_error);
+  ASSERT_THROW(env.MakeMove(Move(0, 3)), std::runtime_error);
+}
+
 TEST_F(EnvironmentTicTacToeFixture, GetValidMoves)
 {
   auto validMoves = env.GetValidMoves();
   ASSERT_EQ(validMoves.size(), 9);
-  env.MakeMove(MoveTicTacToe(0, 0));
+  env.MakeMove(Move(0, 0));
   validMoves = env.GetValidMoves();
   ASSERT_EQ(validMoves.size(), 8);
 }
 
+TEST_F(EnvironmentTicTacToeFixtureRandomMovesPlayed, GetValidMoves_ListsEmptyCells)
+{
+  auto validMoves = env.GetValidMoves();
+  ASSERT_EQ(validMoves.size(), 5);
+  std::vector<Move> expected = {Move(0, 2), Move(1, 0), Move(1, 1), Move(1, 2), Move(2, 0)};
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    ASSERT_EQ(validMoves[i], expected[i]);
+    ASSERT_EQ(validMoves[i].GetIndex(env.GetColumns()), expected[i].GetRow() * 3 + expected[i].GetColumn());
+  }
+  ASSERT_EQ(env.GetMoveHistory().back(), Move(2, 2));
+}
+
 TEST_F(EnvironmentTicTacToeFixture, GetRows)
 {
   ASSERT_EQ(env.GetRows(), 3);
@@ -111,7 +133,7 @@ TEST_F(EnvironmentTicTacToeFixture, GetColumns)
 TEST_F(EnvironmentTicTacToeFixture, GetPlayerAtCoordinates)
 {
   ASSERT_EQ(env.GetPlayerAtCoordinates(0, 0), Player::PLAYER_NONE);
-  env.MakeMove(MoveTicTacToe(0, 0));
+  env.MakeMove(Move(0, 0));
   ASSERT_EQ(env.GetPlayerAtCoordinates(0, 0), Player::PLAYER_1);
 }
 
@@ -137,12 +159,12 @@ TEST_F(EnvironmentTicTacToeFixture, BoardToInput)
 TEST_F(EnvironmentTicTacToeFixture, IsTerminal)
 {
   ASSERT_FALSE(env.IsTerminal());
-  env.MakeMove(MoveTicTacToe(0, 0));
-  env.MakeMove(MoveTicTacToe(1, 0));
-  env.MakeMove(MoveTicTacToe(0, 1));
-  env.MakeMove(MoveTicTacToe(1, 1));
-  env.MakeMove(MoveTicTacToe(0, 2));
-  env.MakeMove(MoveTicTacToe(1, 2));
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(1, 0));
+  env.MakeMove(Move(0, 1));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(0, 2));
+  env.MakeMove(Move(1, 2));
   env.PrintBoard();
   ASSERT_TRUE(env.IsTerminal());
 }
@@ -159,35 +181,133 @@ TEST_F(EnvironmentTicTacToeFixturePlayerXHasWon, GetWinner_PlayerXFixture)
 
 TEST_F(EnvironmentTicTacToeFixture, GetWinner_Horizontal)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
-  env.MakeMove(MoveTicTacToe(1, 0));
-  env.MakeMove(MoveTicTacToe(0, 1));
-  env.MakeMove(MoveTicTacToe(1, 1));
-  env.MakeMove(MoveTicTacToe(0, 2));
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(1, 0));
+  env.MakeMove(Move(0, 1));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(0, 2));
   ASSERT_EQ(env.GetWinner(), Player::PLAYER_1);
 }
 
 TEST_F(EnvironmentTicTacToeFixture, GetWinner_Vertical)
 {
-  env.MakeMove(MoveTicTacToe(0, 1));
-  env.MakeMove(MoveTicTacToe(0, 0));
-  env.MakeMove(MoveTicTacToe(1, 1));
-  env.MakeMove(MoveTicTacToe(1, 0));
-  env.MakeMove(MoveTicTacToe(2, 1));
+  env.MakeMove(Move(0, 1));
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(1, 0));
+  env.MakeMove(Move(2, 1));
   env.PrintBoard();
   ASSERT_EQ(env.GetWinner(), Player::PLAYER_1);
 }
 
 TEST_F(EnvironmentTicTacToeFixture, GetWinner_Diagonal)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
-  env.MakeMove(MoveTicTacToe(0, 1));
-  env.MakeMove(MoveTicTacToe(1, 1));
-  env.MakeMove(MoveTicTacToe(0, 2));
-  env.MakeMove(MoveTicTacToe(2, 2));
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(0, 1));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(0, 2));
+  env.MakeMove(Move(2, 2));
   ASSERT_EQ(env.GetWinner(), Player::PLAYER_1);
 }
 
+TEST_F(EnvironmentTicTacToeFixture, GetWinner_AntiDiagonal)
+{
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(0, 2));
+  env.MakeMove(Move(0, 1));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(1, 0));
+  env.MakeMove(Move(2, 0));
+  ASSERT_EQ(env.GetWinner(), Player::PLAYER_2);
+}
+
+TEST_F(EnvironmentTicTacToeFixture, SetBoard_GetBoard_RoundTrip)
+{
+  auto board  = torch::zeros({3, 3});
+  board[0][0] = 1;
+  board[1][2] = 2;
+  board[2][1] = 1;
+  env.SetBoard(board, Player::PLAYER_2);
+  ASSERT_TRUE(torch::equal(env.GetBoard(), board));
+  ASSERT_EQ(env.GetPlayerAtCoordinates(1, 2), Player::PLAYER_2);
+  ASSERT_FALSE(env.IsValidMove(2, 1));
+  ASSERT_EQ(env.GetValidMoves().size(), 6);
+}
+
+TEST_F(EnvironmentTicTacToeFixture, BoardToInput_Planes)
+{
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(2, 2));
+  auto input = env.BoardToInput();
+  // the pieces keep the number of their player, the last plane is filled with the player to move
+  ASSERT_EQ(input[0][0][0][0].item<float>(), 1.0F);
+  ASSERT_EQ(input[0][1][2][2].item<float>(), 2.0F);
+  ASSERT_EQ(input[0][0][2][2].item<float>(), 0.0F);
+  ASSERT_EQ(input[0][1][0][0].item<float>(), 0.0F);
+  ASSERT_TRUE(torch::equal(input[0][2], torch::full({3, 3}, 1.0F)));
+}
+
+TEST_F(EnvironmentTicTacToeFixtureRandomMovesPlayed, BoardToInput_IntoBatch)
+{
+  auto batch = torch::full({3, env.GetInputPlanes(), 3, 3}, -1.0F);
+  env.BoardToInput(batch, 1);
+  // only the given entry of the batch is written, with the same input as a single position
+  ASSERT_TRUE(torch::equal(batch[1], env.BoardToInput().cpu()[0]));
+  ASSERT_TRUE(torch::equal(batch[0], torch::full({3, 3, 3}, -1.0F)));
+  ASSERT_TRUE(torch::equal(batch[2], torch::full({3, 3, 3}, -1.0F)));
+  ASSERT_THROW(env.BoardToInput(batch, 3), std::runtime_error);
+}
+
+TEST_F(EnvironmentTicTacToeFixture, UndoMove_RestoresWinner)
+{
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(1, 0));
+  env.MakeMove(Move(0, 1));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(0, 2));
+  ASSERT_TRUE(env.IsTerminal());
+  env.UndoMove();
+  ASSERT_EQ(env.GetWinner(), Player::PLAYER_NONE);
+  ASSERT_FALSE(env.IsTerminal());
+  ASSERT_TRUE(env.IsValidMove(0, 2));
+}
+
+TEST_F(EnvironmentTicTacToeFixtureRandomMovesPlayed, GetHash_MatchesHashOfBoard)
+{
+  ASSERT_EQ(env.GetHash(), HashBoard(env.GetBoard(), env.GetCurrentPlayer()));
+  env.MakeMove(Move(1, 1));
+  ASSERT_EQ(env.GetHash(), HashBoard(env.GetBoard(), env.GetCurrentPlayer()));
+  env.SetBoard(env.GetBoard(), Player::PLAYER_1);
+  ASSERT_EQ(env.GetHash(), HashBoard(env.GetBoard(), Player::PLAYER_1));
+}
+
+TEST_F(EnvironmentTicTacToeFixture, GetHash_SamePositionInOtherOrder)
+{
+  auto other = env;
+  env.MakeMove(Move(0, 0));
+  env.MakeMove(Move(1, 1));
+  env.MakeMove(Move(2, 2));
+  other.MakeMove(Move(2, 2));
+  other.MakeMove(Move(1, 1));
+  other.MakeMove(Move(0, 0));
+  ASSERT_EQ(env.GetHash(), other.GetHash());
+  other.TogglePlayer();
+  ASSERT_NE(env.GetHash(), other.GetHash());
+}
+
+TEST_F(EnvironmentTicTacToeFixture, GetHash_UndoMoveRestoresHash)
+{
+  auto emptyHash = env.GetHash();
+  env.MakeMove(Move(1, 2));
+  auto hash = env.GetHash();
+  ASSERT_NE(hash, emptyHash);
+  env.MakeMove(Move(0, 1));
+  env.UndoMove();
+  ASSERT_EQ(env.GetHash(), hash);
+  env.UndoMove();
+  ASSERT_EQ(env.GetHash(), emptyHash);
+}
+
 TEST_F(EnvironmentTicTacToeFixture, PrintBoard)
 {
   ASSERT_NO_THROW(env.PrintBoard());
@@ -217,7 +337,7 @@ TEST_F(EnvironmentTicTacToeFixture, GetValidMoves_EmptyBoard)
 
 TEST_F(EnvironmentTicTacToeFixture, GetValidMoves_OneMovePlayed)
 {
-  env.MakeMove(MoveTicTacToe(0, 0));
+  env.MakeMove(Move(0, 0));
   ASSERT_EQ(env.GetValidMoves().size(), 8);
 }
 